@@ -0,0 +1,269 @@
+// Micro benchmarks of MineField against the code it replaced, which is kept here as the
+// reference. Both sides run on the same fields and their results are compared.
+//
+// Usage: Bench [--seconds S] [--seed S]
+//
+// Neighbor counts: the clamped 3x3 loop the field used to run per tile, against the
+// separable pass of MineField::CountNeighborBombs(), on fields from 8x6 to 4096x4096
+// at expert density.
+// Reveals: the recursive reveal the field used to run, against MineField::OnRevealClick(),
+// clicking every zero tile of a new field in turn, with the deepest recursion reached.
+// 250x250 is below the size where MineField labels openings, so it flood fills with its
+// worklist. 1000x1000 sweeps the openings, labeling them on the first click is part of
+// the time. MineField's times also include recording every click in its undo journal.
+// Every measurement repeats until it took S seconds (default 0.25)
+#include "MineField.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct Options
+	{
+		double seconds = 0.25;
+		uint64_t seed = 0;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "Missing value for %s\n", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--seconds") == 0)
+			{
+				options.seconds = std::atof(value);
+			}
+			else if (std::strcmp(arg, "--seed") == 0)
+			{
+				options.seed = std::strtoull(value, nullptr, 10);
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", arg);
+				return false;
+			}
+		}
+
+		if (options.seconds <= 0.0)
+		{
+			std::fprintf(stderr, "Invalid time\n");
+			return false;
+		}
+		return true;
+	}
+
+	// Average seconds per call of run, called until seconds have passed
+	template<typename F>
+	double Time(double seconds, F run)
+	{
+		typedef std::chrono::steady_clock Clock;
+		const Clock::time_point start = Clock::now();
+		long long nRuns = 0;
+		std::chrono::duration<double> elapsed(0.0);
+		do
+		{
+			run();
+			nRuns++;
+			elapsed = Clock::now() - start;
+		} while (elapsed.count() < seconds);
+		return elapsed.count() / double(nRuns);
+	}
+
+	// Expert density, 99 mines on 480 tiles
+	int ExpertMines(int width, int height)
+	{
+		return std::max(1, int((long long)width * height * 99 / 480));
+	}
+
+	// The per-tile count MineField had before the separable pass
+	int CountNeighborBombsOld(const BitPlane& mines, int width, int height, const Vei2& gridPos)
+	{
+		const int xStart = std::max(0, gridPos.x - 1);
+		const int yStart = std::max(0, gridPos.y - 1);
+		const int xEnd = std::min(width - 1, gridPos.x + 1);
+		const int yEnd = std::min(height - 1, gridPos.y + 1);
+
+		int count = 0;
+		for (Vei2 pos = { xStart,yStart }; pos.y <= yEnd; pos.y++)
+		{
+			for (pos.x = xStart; pos.x <= xEnd; pos.x++)
+			{
+				if (mines.Get(pos.y * width + pos.x))
+				{
+					count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	// The reveal MineField had before the worklist: every zero tile calls it again on all
+	// its neighbors, so the stack grows with the open area. Keeps the deepest call in depth
+	void RevealRecursive(const MineField& field, BitPlane& revealed, const Vei2& gridPos, int level, int& depth)
+	{
+		const int i = gridPos.y * field.GetWidth() + gridPos.x;
+		depth = std::max(depth, level);
+
+		if (!revealed.Get(i))
+		{
+			revealed.Set(i);
+
+			if (!field.HasBomb(gridPos) && field.GetNeighborBombCount(gridPos) == 0)
+			{
+				const int xStart = std::max(0, gridPos.x - 1);
+				const int yStart = std::max(0, gridPos.y - 1);
+				const int xEnd = std::min(field.GetWidth() - 1, gridPos.x + 1);
+				const int yEnd = std::min(field.GetHeight() - 1, gridPos.y + 1);
+
+				for (Vei2 pos = { xStart,yStart }; pos.y <= yEnd; pos.y++)
+				{
+					for (pos.x = xStart; pos.x <= xEnd; pos.x++)
+					{
+						RevealRecursive(field, revealed, pos, level + 1, depth);
+					}
+				}
+			}
+		}
+	}
+
+	bool BenchReveals(const Options& options)
+	{
+		struct Case
+		{
+			Vei2 size;
+			int nMines;
+		};
+		// At 10% mines the biggest opening has tens of thousands of zero tiles
+		const Case cases[] = {
+			{ { 250,250 },ExpertMines(250, 250) },
+			{ { 1000,1000 },ExpertMines(1000, 1000) },
+			{ { 1000,1000 },1000 * 1000 / 10 } };
+
+		std::printf("Reveals of every opening, ms per field\n");
+		std::printf("%-12s %6s %12s %12s %9s %12s\n", "Field", "Mines", "Recursive", "MineField", "Speedup", "Max depth");
+		for (const Case& c : cases)
+		{
+			const Vei2& size = c.size;
+			const MineField newField(size.x, size.y, c.nMines, options.seed);
+			std::vector<Vei2> zeroTiles;
+			for (Vei2 pos = { 0,0 }; pos.y < size.y; pos.y++)
+			{
+				for (pos.x = 0; pos.x < size.x; pos.x++)
+				{
+					if (!newField.HasBomb(pos) && newField.GetNeighborBombCount(pos) == 0)
+					{
+						zeroTiles.push_back(pos);
+					}
+				}
+			}
+
+			BitPlane oldRevealed;
+			int depth = 0;
+			const double oldTime = Time(options.seconds, [&]()
+			{
+				oldRevealed = BitPlane(size.x * size.y);
+				for (const Vei2& pos : zeroTiles)
+				{
+					RevealRecursive(newField, oldRevealed, pos, 1, depth);
+				}
+			});
+
+			MineField field = newField;
+			const double newTime = Time(options.seconds, [&]()
+			{
+				field = newField;
+				for (const Vei2& pos : zeroTiles)
+				{
+					field.OnRevealClick(pos);
+				}
+			});
+
+			for (int w = 0; w < oldRevealed.GetWordCount(); w++)
+			{
+				if (oldRevealed.GetWord(w) != field.GetRevealedPlane().GetWord(w))
+				{
+					std::fprintf(stderr, "Revealed tiles differ on %dx%d near tile %d\n", size.x, size.y, w * 64);
+					return false;
+				}
+			}
+
+			char name[32];
+			std::snprintf(name, sizeof(name), "%dx%d", size.x, size.y);
+			std::printf("%-12s %5.1f%% %12.3f %12.3f %8.1fx %12d\n", name, 100.0 * c.nMines / (size.x * size.y),
+				oldTime * 1e3, newTime * 1e3, oldTime / newTime, depth);
+		}
+		return true;
+	}
+
+	bool BenchNeighborCounts(const Options& options)
+	{
+		const Vei2 sizes[] = { { 8,6 },{ 16,16 },{ 30,16 },{ 64,64 },{ 256,256 },{ 1024,1024 },{ 4096,4096 } };
+
+		std::printf("Neighbor counts, ns per tile\n");
+		std::printf("%-12s %12s %12s %9s\n", "Field", "3x3 loop", "Separable", "Speedup");
+		for (const Vei2& size : sizes)
+		{
+			const MineField field(size.x, size.y, ExpertMines(size.x, size.y), options.seed);
+			const BitPlane& mines = field.GetMinePlane();
+			const int nTiles = size.x * size.y;
+			std::vector<unsigned char> oldCounts(nTiles);
+			std::vector<unsigned char> newCounts(nTiles);
+
+			const double oldTime = Time(options.seconds, [&]()
+			{
+				for (Vei2 pos = { 0,0 }; pos.y < size.y; pos.y++)
+				{
+					for (pos.x = 0; pos.x < size.x; pos.x++)
+					{
+						oldCounts[pos.y * size.x + pos.x] = (unsigned char)CountNeighborBombsOld(mines, size.x, size.y, pos);
+					}
+				}
+			});
+			const double newTime = Time(options.seconds, [&]()
+			{
+				MineField::CountNeighborBombs(mines, size.x, size.y, newCounts.data());
+			});
+
+			// The separable pass also counts the mine itself on mine tiles, which never show a number
+			for (int i = 0; i < nTiles; i++)
+			{
+				if (!mines.Get(i) && oldCounts[i] != newCounts[i])
+				{
+					std::fprintf(stderr, "Counts differ on %dx%d at tile %d\n", size.x, size.y, i);
+					return false;
+				}
+			}
+
+			char name[32];
+			std::snprintf(name, sizeof(name), "%dx%d", size.x, size.y);
+			std::printf("%-12s %12.2f %12.2f %8.1fx\n", name, oldTime * 1e9 / nTiles, newTime * 1e9 / nTiles,
+				oldTime / newTime);
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	const bool countsMatch = BenchNeighborCounts(options);
+	std::printf("\n");
+	const bool revealsMatch = BenchReveals(options);
+	return countsMatch && revealsMatch ? 0 : 1;
+}
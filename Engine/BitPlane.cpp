@@ -0,0 +1,101 @@
+#include "BitPlane.h"
+#include <assert.h>
+#include <algorithm>
+
+BitPlane::BitPlane(int nBits)
+	:
+	nBits(nBits),
+	nWords((nBits + 63) / 64)
+{
+	assert(nBits >= 0);
+
+	if (nWords > nInlineWords)
+	{
+		heapWords.resize(nWords, 0u);
+		words = heapWords.data();
+	}
+}
+
+BitPlane::BitPlane(int nBits, uint64_t* externalWords)
+	:
+	nBits(nBits),
+	nWords((nBits + 63) / 64),
+	words(externalWords)
+{
+	assert(nBits >= 0);
+}
+
+BitPlane::BitPlane(const BitPlane& src)
+{
+	*this = src;
+}
+
+BitPlane::BitPlane(BitPlane&& donor)
+{
+	*this = std::move(donor);
+}
+
+BitPlane& BitPlane::operator=(const BitPlane& rhs)
+{
+	if (this != &rhs)
+	{
+		nBits = rhs.nBits;
+		nWords = rhs.nWords;
+		// Copy through the words pointer, so copies of views get their own words
+		if (nWords > nInlineWords)
+		{
+			heapWords.assign(rhs.words, rhs.words + nWords);
+			words = heapWords.data();
+		}
+		else
+		{
+			heapWords.clear();
+			std::fill(std::copy(rhs.words, rhs.words + nWords, inlineWords), inlineWords + nInlineWords, 0u);
+			words = inlineWords;
+		}
+	}
+	return *this;
+}
+
+BitPlane& BitPlane::operator=(BitPlane&& donor)
+{
+	if (this != &donor)
+	{
+		nBits = donor.nBits;
+		nWords = donor.nWords;
+		std::copy(donor.inlineWords, donor.inlineWords + nInlineWords, inlineWords);
+		// Heap words keep their address when the vector is moved, and views keep pointing
+		// at the same external words
+		const bool donorIsInline = donor.words == donor.inlineWords;
+		heapWords = std::move(donor.heapWords);
+		words = donorIsInline ? inlineWords : donor.words;
+
+		donor.nBits = 0;
+		donor.nWords = 0;
+		donor.words = donor.inlineWords;
+	}
+	return *this;
+}
+
+int BitPlane::GetBitCount() const
+{
+	return nBits;
+}
+
+int BitPlane::Count() const
+{
+	int count = 0;
+	for (int i = 0; i < nWords; i++)
+	{
+		count += PopCount(words[i]);
+	}
+	return count;
+}
+
+int BitPlane::PopCount(uint64_t w)
+{
+	w = w - ((w >> 1) & 0x5555555555555555ull);
+	w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return int((w * 0x0101010101010101ull) >> 56);
+}
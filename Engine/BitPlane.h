@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// One bit per tile, packed 64 tiles to a word (tile i lives in bit i % 64 of word i / 64).
+// Planes up to nInlineWords words (expert size and below) live inside the object,
+// larger planes are stored contiguously on the heap. A plane can also be a view over
+// words owned by someone else, such as a memory-mapped file
+class BitPlane
+{
+public:
+	BitPlane(int nBits = 0);
+	// View over (nBits + 63) / 64 external words, which must outlive the plane.
+	// Copies of a view own their words
+	BitPlane(int nBits, uint64_t* externalWords);
+	BitPlane(const BitPlane& src);
+	BitPlane(BitPlane&& donor);
+	BitPlane& operator=(const BitPlane& rhs);
+	BitPlane& operator=(BitPlane&& donor);
+	bool Get(int i) const
+	{
+		return ((words[i >> 6] >> (i & 63)) & 1u) != 0;
+	}
+	void Set(int i)
+	{
+		words[i >> 6] |= uint64_t(1) << (i & 63);
+	}
+	void Reset(int i)
+	{
+		words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+	}
+	void Toggle(int i)
+	{
+		words[i >> 6] ^= uint64_t(1) << (i & 63);
+	}
+	int GetBitCount() const;
+	int GetWordCount() const
+	{
+		return nWords;
+	}
+	uint64_t GetWord(int w) const
+	{
+		return words[w];
+	}
+	const uint64_t* GetWords() const
+	{
+		return words;
+	}
+	// Number of set bits in the whole plane
+	int Count() const;
+	static int PopCount(uint64_t w);
+
+private:
+	static constexpr int nInlineWords = 8;
+	int nBits = 0;
+	int nWords = 0;
+	uint64_t* words = inlineWords;
+	uint64_t inlineWords[nInlineWords] = {};
+	std::vector<uint64_t> heapWords;
+};
@@ -0,0 +1,213 @@
+#include "BoardStats.h"
+#include <assert.h>
+#include <algorithm>
+#include <thread>
+
+BoardStats::BoardStats(const MineField& field)
+{
+	Scratch scratch;
+	*this = BoardStats(field, scratch);
+}
+
+BoardStats::BoardStats(const MineField& field, Scratch& scratch)
+{
+	const int width = field.GetWidth();
+	const int height = field.GetHeight();
+	const BitPlane& mines = field.GetMinePlane();
+	const unsigned char* const counts = field.GetNeighborCounts();
+
+	// Whether each tile has a zero tile in its 3x3 area is a separable OR: every row
+	// gets its horizontal 3-tile OR, and three of those rows give the answer.
+	// Bombs never count 0, so a 0 count is a zero tile
+	for (std::vector<unsigned char>& rowOr : scratch.rowOrs)
+	{
+		rowOr.resize(width);
+	}
+	auto orRow = [&](int y, std::vector<unsigned char>& out)
+	{
+		if (y < 0 || y >= height)
+		{
+			std::fill(out.begin(), out.end(), (unsigned char)0u);
+			return;
+		}
+		const unsigned char* const row = counts + y * width;
+		for (int x = 0; x < width; x++)
+		{
+			out[x] = row[x] == 0u ? 1u : 0u;
+		}
+		const unsigned char* const zero = out.data();
+		unsigned char left = 0u;
+		for (int x = 0; x < width; x++)
+		{
+			const unsigned char self = zero[x];
+			out[x] = (unsigned char)(left | self | (x + 1 < width ? zero[x + 1] : 0u));
+			left = self;
+		}
+	};
+
+	std::vector<unsigned char>* above = &scratch.rowOrs[0];
+	std::vector<unsigned char>* current = &scratch.rowOrs[1];
+	std::vector<unsigned char>* below = &scratch.rowOrs[2];
+	orRow(-1, *above);
+	orRow(0, *current);
+
+	// Openings and islands are found with union-find in the same pass, linking each
+	// zero tile or isolated tile to the ones before it among its 8 neighbors. A zero
+	// tile never touches an isolated one, so both share one parent array and every
+	// link stays within its kind. Every tile is written as it is passed, so the array
+	// needs no clearing between boards
+	std::vector<int>& parent = scratch.parent;
+	parent.resize(size_t(width) * size_t(height));
+	auto find = [&parent](int t)
+	{
+		while (parent[t] != t)
+		{
+			parent[t] = parent[parent[t]];
+			t = parent[t];
+		}
+		return t;
+	};
+	auto unite = [&](int a, int b, int& nGroups)
+	{
+		a = find(a);
+		b = find(b);
+		if (a != b)
+		{
+			parent[std::max(a, b)] = std::min(a, b);
+			nGroups--;
+		}
+	};
+
+	int histogram[10] = {};
+	for (int y = 0; y < height; y++)
+	{
+		orRow(y + 1, *below);
+		for (int x = 0; x < width; x++)
+		{
+			// Bombs go to an extra bin instead of a branch, on a random field it is random
+			const int i = y * width + x;
+			const bool isMine = mines.Get(i);
+			histogram[isMine ? 9 : counts[i]]++;
+			parent[i] = -1;
+			if (isMine)
+			{
+				continue;
+			}
+			int* pGroups = &nOpenings;
+			if (counts[i] != 0u)
+			{
+				if (((*above)[x] | (*current)[x] | (*below)[x]) != 0u)
+				{
+					continue;
+				}
+				nIsolated++;
+				pGroups = &nIslands;
+			}
+
+			(*pGroups)++;
+			parent[i] = i;
+			if (x > 0 && parent[i - 1] != -1)
+			{
+				unite(i, i - 1, *pGroups);
+			}
+			if (y > 0)
+			{
+				for (int n = std::max(0, x - 1); n <= std::min(width - 1, x + 1); n++)
+				{
+					if (parent[i - width + n - x] != -1)
+					{
+						unite(i, i - width + n - x, *pGroups);
+					}
+				}
+			}
+		}
+
+		// Slide the window one row down
+		std::swap(above, current);
+		std::swap(current, below);
+	}
+	std::copy(histogram, histogram + 9, numberCounts);
+}
+
+std::vector<BoardStats> BoardStats::ComputeBatch(int width, int height, int nMines,
+	const std::vector<uint64_t>& seeds, int nThreads)
+{
+	return ComputeBatch(width, height, nMines, seeds, nullptr, nThreads);
+}
+
+std::vector<BoardStats> BoardStats::ComputeBatch(int width, int height, int nMines,
+	const std::vector<uint64_t>& seeds, const Vei2& safeStart, int nThreads)
+{
+	return ComputeBatch(width, height, nMines, seeds, &safeStart, nThreads);
+}
+
+std::vector<BoardStats> BoardStats::ComputeBatch(int width, int height, int nMines,
+	const std::vector<uint64_t>& seeds, const Vei2* pSafeStart, int nThreads)
+{
+	if (nThreads <= 0)
+	{
+		nThreads = int(std::thread::hardware_concurrency());
+	}
+	nThreads = std::max(1, std::min<int>(nThreads, int(seeds.size())));
+
+	// Each thread builds and measures one contiguous slice of the seeds and writes
+	// only its own slice of the results
+	std::vector<BoardStats> stats(seeds.size());
+	const size_t sliceSize = (seeds.size() + nThreads - 1) / nThreads;
+	auto work = [&](size_t begin, size_t end)
+	{
+		Scratch scratch;
+		for (size_t i = begin; i < end; i++)
+		{
+			if (pSafeStart != nullptr)
+			{
+				stats[i] = BoardStats(MineField(width, height, nMines, seeds[i], *pSafeStart), scratch);
+			}
+			else
+			{
+				stats[i] = BoardStats(MineField(width, height, nMines, seeds[i]), scratch);
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t begin = sliceSize; begin < seeds.size(); begin += sliceSize)
+	{
+		workers.emplace_back(work, begin, std::min(seeds.size(), begin + sliceSize));
+	}
+
+	// The calling thread takes the first slice
+	work(0, std::min(seeds.size(), sliceSize));
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	return stats;
+}
+
+int BoardStats::Get3BV() const
+{
+	return nOpenings + nIsolated;
+}
+
+int BoardStats::GetOpeningCount() const
+{
+	return nOpenings;
+}
+
+int BoardStats::GetIsolatedCount() const
+{
+	return nIsolated;
+}
+
+int BoardStats::GetIslandCount() const
+{
+	return nIslands;
+}
+
+int BoardStats::GetNumberCount(int n) const
+{
+	assert(n >= 0 && n <= 8);
+	return numberCounts[n];
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "MineField.h"
+#include <vector>
+#include <stdint.h>
+
+// Difficulty statistics of a MineField's layout, independent of the game state.
+// 3BV is the smallest number of clicks that clears the field: one per opening plus
+// one per number tile that touches no opening. Those number tiles form islands
+class BoardStats
+{
+public:
+	BoardStats() = default;
+	// Computed in one pass over the tiles, openings and islands included
+	BoardStats(const MineField& field);
+	// Stats of the fields built from every seed, in seed order, on nThreads worker
+	// threads (0 for one per core)
+	static std::vector<BoardStats> ComputeBatch(int width, int height, int nMines,
+		const std::vector<uint64_t>& seeds, int nThreads = 0);
+	// Same for fields built with a safe start, like the ones NoGuessGenerator finds
+	static std::vector<BoardStats> ComputeBatch(int width, int height, int nMines,
+		const std::vector<uint64_t>& seeds, const Vei2& safeStart, int nThreads = 0);
+	int Get3BV() const;
+	int GetOpeningCount() const;
+	// Number tiles that touch no opening, each one needs its own click
+	int GetIsolatedCount() const;
+	// Groups of touching isolated number tiles
+	int GetIslandCount() const;
+	// Safe tiles showing number n, 0 to 8
+	int GetNumberCount(int n) const;
+
+private:
+	// Buffers of the pass, kept by ComputeBatch() from one board to the next
+	struct Scratch
+	{
+		std::vector<unsigned char> rowOrs[3];
+		std::vector<int> parent;
+	};
+
+private:
+	BoardStats(const MineField& field, Scratch& scratch);
+	static std::vector<BoardStats> ComputeBatch(int width, int height, int nMines,
+		const std::vector<uint64_t>& seeds, const Vei2* pSafeStart, int nThreads);
+
+private:
+	int nOpenings = 0;
+	int nIsolated = 0;
+	int nIslands = 0;
+	int numberCounts[9] = {};
+};
@@ -27,9 +27,12 @@ Game::Game( MainWindow& wnd )
 	:
 	wnd( wnd ),
 	gfx( wnd ),
-	field(gfx.GetRect().GetCenter(), 4)
+	field(4),
+	fieldView(field, gfx.GetRect().GetCenter()),
+	replay(field.GetWidth(), field.GetHeight(), field.GetMineCount(), field.GetSeed())
 {
-
+	field.EnableUndo();
+	fieldView.SetReplay(&replay);
 }
 
 void Game::Go()
@@ -42,21 +45,40 @@ void Game::Go()
 
 void Game::UpdateModel()
 {	
+	// Ctrl+Z and Ctrl+Y step through the field's undo journal, also after losing
+	while (!wnd.kbd.KeyIsEmpty())
+	{
+		const auto e = wnd.kbd.ReadKey();
+		if (e.IsPress() && wnd.kbd.KeyIsPressed(VK_CONTROL))
+		{
+			if (e.GetCode() == 'Z')
+			{
+				// A replay cannot show undone clicks, so the game is no longer recorded
+				fieldView.SetReplay(nullptr);
+				isRecording = false;
+				field.Undo();
+			}
+			else if (e.GetCode() == 'Y')
+			{
+				field.Redo();
+			}
+		}
+	}
+
 	// Events to process for mouse
 	while (!wnd.mouse.IsEmpty())
 	{
+		const auto e = wnd.mouse.Read();
 		if (field.GetState() == MineField::State::Mineming)
 		{
-			const auto e = wnd.mouse.Read();
-
 			// Left pressed for flags
 			if (e.GetType() == Mouse::Event::Type::LPress)
 			{
 				const Vei2 mousePosition = e.GetPos();
 
-				if (field.GetRect().Contains(mousePosition))
+				if (fieldView.GetRect().Contains(mousePosition))
 				{
-					field.OnRevealClick(mousePosition);
+					fieldView.OnRevealClick(mousePosition);
 				}
 			}
 			// Right pressed for reveal
@@ -64,20 +86,27 @@ void Game::UpdateModel()
 			{
 				const Vei2 mousePosition = e.GetPos();
 
-				if (field.GetRect().Contains(mousePosition))
+				if (fieldView.GetRect().Contains(mousePosition))
 				{
-					field.OnFlagClick(mousePosition);
+					fieldView.OnFlagClick(mousePosition);
 				}
 			}
 		}
 	}
+
+	if (isRecording && field.GetState() == MineField::State::Winrar)
+	{
+		replay.Save("replay.mrp");
+		fieldView.SetReplay(nullptr);
+		isRecording = false;
+	}
 }
 
 
 void Game::ComposeFrame()
 {
 	
-	field.Draw(gfx);
+	fieldView.Draw(gfx);
 
 	if (field.GetState() == MineField::State::Winrar)
 	{
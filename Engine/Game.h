@@ -24,6 +24,7 @@
 #include "Mouse.h"
 #include "Graphics.h"
 #include "MineField.h"
+#include "MineFieldView.h"
 
 class Game
 {
@@ -44,5 +45,9 @@ private:
 	/********************************/
 	/*  User Variables              */
 	MineField field;
+	MineFieldView fieldView;
+	// Every click of the game, saved to replay.mrp when it is won without using undo
+	Replay replay;
+	bool isRecording = true;
 	/********************************/
 };
\ No newline at end of file
@@ -20,11 +20,71 @@
 ******************************************************************************************/
 #include "MainWindow.h"
 #include "Graphics.h"
-#include "DXErr.h"
-#include "ChiliException.h"
+#include "RleSprite.h"
 #include <assert.h>
 #include <string>
 #include <array>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRAPHICS_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef CHILI_HEADLESS
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+Graphics::Graphics( HWNDKey& )
+{
+	// no device, the sysbuffer is the whole backend
+	pSysBuffer = new Color[Graphics::ScreenWidth * Graphics::ScreenHeight];
+
+	const char* const pDumpPath = std::getenv( "CHILI_FRAME_DUMP" );
+	if( pDumpPath != nullptr )
+	{
+		frameDumpPath = pDumpPath;
+	}
+}
+
+Graphics::~Graphics()
+{
+	delete[] pSysBuffer;
+	pSysBuffer = nullptr;
+}
+
+void Graphics::EndFrame()
+{
+	if( frameDumpPath.empty() )
+	{
+		return;
+	}
+
+	// binary PPM, overwritten every frame so the file holds the last one
+	FILE* const pFile = std::fopen( frameDumpPath.c_str(),"wb" );
+	if( pFile == nullptr )
+	{
+		return;
+	}
+	std::fprintf( pFile,"P6\n%d %d\n255\n",Graphics::ScreenWidth,Graphics::ScreenHeight );
+	unsigned char row[Graphics::ScreenWidth * 3];
+	for( int y = 0; y < Graphics::ScreenHeight; y++ )
+	{
+		for( int x = 0; x < Graphics::ScreenWidth; x++ )
+		{
+			const Color c = pSysBuffer[y * Graphics::ScreenWidth + x];
+			row[x * 3] = c.GetR();
+			row[x * 3 + 1] = c.GetG();
+			row[x * 3 + 2] = c.GetB();
+		}
+		std::fwrite( row,1,sizeof( row ),pFile );
+	}
+	std::fclose( pFile );
+}
+#else
+#include "DXErr.h"
+#include "ChiliException.h"
 
 // Ignore the intellisense error "cannot open source file" for .shh files.
 // They will be created during the build sequence before the preprocessor runs.
@@ -300,6 +360,7 @@ void Graphics::EndFrame()
 		}
 	}
 }
+#endif
 
 void Graphics::BeginFrame()
 {
@@ -323,16 +384,112 @@ void Graphics::PutPixel( int x,int y,Color c )
 
 void Graphics::DrawRect( int x0,int y0,int x1,int y1,Color c )
 {
+	// clip once, then fill each visible row with the color
+	x0 = std::max( x0,0 );
+	y0 = std::max( y0,0 );
+	x1 = std::min( x1,int( ScreenWidth ) );
+	y1 = std::min( y1,int( ScreenHeight ) );
+	if( x0 >= x1 || y0 >= y1 )
+	{
+		return;
+	}
+	const int spanWidth = x1 - x0;
 	for( int y = y0; y < y1; ++y )
 	{
-		for( int x = x0; x < x1; ++x )
+		std::fill_n( pSysBuffer + ScreenWidth * y + x0,spanWidth,c );
+	}
+}
+
+void Graphics::DrawSprite( int x,int y,int width,int height,const Color* pPixels )
+{
+	// clip once for the whole sprite so the row loop never checks bounds
+	const int xStart = std::max( 0,-x );
+	const int yStart = std::max( 0,-y );
+	const int xEnd = std::min( width,ScreenWidth - x );
+	const int yEnd = std::min( height,ScreenHeight - y );
+	for( int sy = yStart; sy < yEnd; sy++ )
+	{
+		const Color* pSrc = pPixels + sy * width + xStart;
+		Color* pDst = pSysBuffer + (y + sy) * ScreenWidth + x + xStart;
+		const int n = xEnd - xStart;
+		int i = 0;
+#ifdef GRAPHICS_USE_SSE2
+		// four pixels at a time, pixels whose X byte is 255 make a mask that picks the screen
+		const __m128i transparentX = _mm_set1_epi32( 255 );
+		for( ; i + 4 <= n; i += 4 )
+		{
+			const __m128i src = _mm_loadu_si128( reinterpret_cast<const __m128i*>(pSrc + i) );
+			const __m128i dst = _mm_loadu_si128( reinterpret_cast<const __m128i*>(pDst + i) );
+			const __m128i transparent = _mm_cmpeq_epi32( _mm_srli_epi32( src,24 ),transparentX );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>(pDst + i),
+				_mm_or_si128( _mm_andnot_si128( transparent,src ),_mm_and_si128( transparent,dst ) ) );
+		}
+#endif
+		// the remaining pixels, or the whole row without SSE2
+		for( ; i < n; i++ )
+		{
+			if( pSrc[i].GetX() != 255 )
+			{
+				pDst[i] = pSrc[i];
+			}
+		}
+	}
+}
+
+void Graphics::DrawSpriteOpaque( int x,int y,int width,int height,const Color* pPixels )
+{
+	const int xStart = std::max( 0,-x );
+	const int yStart = std::max( 0,-y );
+	const int xEnd = std::min( width,ScreenWidth - x );
+	const int yEnd = std::min( height,ScreenHeight - y );
+	if( xStart >= xEnd )
+	{
+		return;
+	}
+	for( int sy = yStart; sy < yEnd; sy++ )
+	{
+		std::copy_n( pPixels + sy * width + xStart,xEnd - xStart,pSysBuffer + (y + sy) * ScreenWidth + x + xStart );
+	}
+}
+
+void Graphics::DrawSprite( int x,int y,const RleSprite& sprite )
+{
+	// sprites fully on screen skip the per span clipping
+	const bool isClipped = x < 0 || y < 0 ||
+		x + sprite.GetWidth() > ScreenWidth || y + sprite.GetHeight() > ScreenHeight;
+	const unsigned short* pRun = sprite.GetRuns();
+	const Color* pSrc = sprite.GetPixels();
+	for( int sy = y; sy < y + sprite.GetHeight(); sy++ )
+	{
+		const int nSpans = *pRun++;
+		const bool isRowVisible = sy >= 0 && sy < ScreenHeight;
+		for( int n = 0; n < nSpans; n++,pRun += 2 )
 		{
-			PutPixel( x,y,c );
+			int xStart = x + pRun[0];
+			int xEnd = xStart + pRun[1];
+			const Color* pSpan = pSrc;
+			pSrc += pRun[1];
+			if( isClipped )
+			{
+				if( !isRowVisible )
+				{
+					continue;
+				}
+				pSpan += std::max( 0,-xStart );
+				xStart = std::max( 0,xStart );
+				xEnd = std::min( ScreenWidth,xEnd );
+				if( xStart >= xEnd )
+				{
+					continue;
+				}
+			}
+			std::copy_n( pSpan,xEnd - xStart,pSysBuffer + sy * ScreenWidth + xStart );
 		}
 	}
 }
 
 
+#ifndef CHILI_HEADLESS
 //////////////////////////////////////////////////
 //           Graphics Exception
 Graphics::Exception::Exception( HRESULT hr,const std::wstring& note,const wchar_t* file,unsigned int line )
@@ -373,4 +530,5 @@ std::wstring Graphics::Exception::GetErrorDescription() const
 std::wstring Graphics::Exception::GetExceptionType() const
 {
 	return L"Chili Graphics Exception";
-}
\ No newline at end of file
+}
+#endif
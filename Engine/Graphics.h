@@ -19,15 +19,21 @@
 *	along with The Chili DirectX Framework.  If not, see <http://www.gnu.org/licenses/>.  *
 ******************************************************************************************/
 #pragma once
+// Define CHILI_HEADLESS to build without Direct3D: frames are only drawn into the
+// sysbuffer, and EndFrame() dumps the frame to a file or does nothing
+#ifndef CHILI_HEADLESS
 #include "ChiliWin.h"
 #include <d3d11.h>
 #include <wrl.h>
 #include "ChiliException.h"
+#endif
 #include "Colors.h"
 #include "RectI.h"
+#include <string>
 
 class Graphics
 {
+#ifndef CHILI_HEADLESS
 public:
 	class Exception : public ChiliException
 	{
@@ -47,6 +53,7 @@ private:
 		float x,y,z;		// position
 		float u,v;			// texcoords
 	};
+#endif
 public:
 	Graphics( class HWNDKey& key );
 	Graphics( const Graphics& ) = delete;
@@ -56,16 +63,25 @@ public:
 	RectI GetRect() const;
 	void PutPixel( int x,int y,int r,int g,int b )
 	{
-		PutPixel( x,y,{ unsigned char( r ),unsigned char( g ),unsigned char( b ) } );
+		PutPixel( x,y,{ (unsigned char)r,(unsigned char)g,(unsigned char)b } );
 	}
 	void PutPixel( int x,int y,Color c );
+	// Fills [x0,x1) x [y0,y1), clipped to the screen
 	void DrawRect( int x0,int y0,int x1,int y1,Color c );
 	void DrawRect( const RectI& rect,Color c )
 	{
 		DrawRect( rect.left,rect.top,rect.right,rect.bottom,c );
 	}
+	// Sprite pixels with an X byte of 255 leave the screen alone, any other X is drawn.
+	// Clipped to the screen once, then blitted row by row four pixels at a time
+	void DrawSprite( int x,int y,int width,int height,const Color* pPixels );
+	// Sprite with every pixel drawn, each clipped row is a single memcpy
+	void DrawSpriteOpaque( int x,int y,int width,int height,const Color* pPixels );
+	// Only the opaque spans are touched, each copied whole with one clip per span
+	void DrawSprite( int x,int y,const class RleSprite& sprite );
 	~Graphics();
 private:
+#ifndef CHILI_HEADLESS
 	Microsoft::WRL::ComPtr<IDXGISwapChain>				pSwapChain;
 	Microsoft::WRL::ComPtr<ID3D11Device>				pDevice;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext>			pImmediateContext;
@@ -78,6 +94,10 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11InputLayout>			pInputLayout;
 	Microsoft::WRL::ComPtr<ID3D11SamplerState>			pSamplerState;
 	D3D11_MAPPED_SUBRESOURCE							mappedSysBufferTexture;
+#else
+	// Binary PPM file every frame is written to, from the CHILI_FRAME_DUMP environment variable
+	std::string frameDumpPath;
+#endif
 	Color*                                              pSysBuffer = nullptr;
 public:
 	static constexpr int ScreenWidth = 800;
@@ -20,6 +20,43 @@
 ******************************************************************************************/
 #include "MainWindow.h"
 #include "Game.h"
+#ifdef CHILI_HEADLESS
+#include "Xoshiro256.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Plays without a window or GPU for benchmarking the drawing code: Engine [frames] [seed].
+// Every frame clicks a random spot in the middle of the screen, where the field is
+int main( int argc,char** argv )
+{
+	const int nFrames = argc > 1 ? std::atoi( argv[1] ) : 10000;
+	Xoshiro256 rng( argc > 2 ? std::strtoull( argv[2],nullptr,10 ) : 0u );
+
+	MainWindow wnd( nFrames );
+	Game theGame( wnd );
+	const auto start = std::chrono::steady_clock::now();
+	while( wnd.ProcessMessage() )
+	{
+		const int x = Graphics::ScreenWidth * 3 / 8 + int( rng.Bounded( Graphics::ScreenWidth / 4 ) );
+		const int y = Graphics::ScreenHeight * 3 / 8 + int( rng.Bounded( Graphics::ScreenHeight / 4 ) );
+		if( rng.Bounded( 4u ) == 0u )
+		{
+			wnd.PressRight( x,y );
+		}
+		else
+		{
+			wnd.PressLeft( x,y );
+		}
+		theGame.Go();
+	}
+	const std::chrono::duration<double,std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::fprintf( stderr,"Frames:       %d\n",nFrames );
+	std::fprintf( stderr,"Frame time:   %.2f us\n",elapsed.count() / double( nFrames ) );
+	return 0;
+}
+#else
 #include "ChiliException.h"
 
 int WINAPI wWinMain( HINSTANCE hInst,HINSTANCE,LPWSTR pArgs,INT )
@@ -76,4 +113,5 @@ int WINAPI wWinMain( HINSTANCE hInst,HINSTANCE,LPWSTR pArgs,INT )
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -19,6 +19,46 @@
 *	along with The Chili DirectX Framework.  If not, see <http://www.gnu.org/licenses/>.  *
 ******************************************************************************************/
 #include "MainWindow.h"
+#ifdef CHILI_HEADLESS
+#include <cstdio>
+
+MainWindow::MainWindow( int nFrames )
+	:
+	nFramesLeft( nFrames )
+{
+}
+
+void MainWindow::ShowMessageBox( const std::wstring& title,const std::wstring& message ) const
+{
+	std::fprintf( stderr,"%ls: %ls\n",title.c_str(),message.c_str() );
+}
+
+bool MainWindow::ProcessMessage()
+{
+	if( nFramesLeft <= 0 )
+	{
+		return false;
+	}
+	nFramesLeft--;
+	return true;
+}
+
+void MainWindow::PressLeft( int x,int y )
+{
+	// events take their position from the last move, like with a real mouse
+	mouse.OnMouseMove( x,y );
+	mouse.OnLeftPressed( x,y );
+	mouse.OnLeftReleased( x,y );
+}
+
+void MainWindow::PressRight( int x,int y )
+{
+	// events take their position from the last move, like with a real mouse
+	mouse.OnMouseMove( x,y );
+	mouse.OnRightPressed( x,y );
+	mouse.OnRightReleased( x,y );
+}
+#else
 #include "Resource.h"
 #include "Graphics.h"
 #include "ChiliException.h"
@@ -225,4 +265,5 @@ LRESULT MainWindow::HandleMsg( HWND hWnd,UINT msg,WPARAM wParam,LPARAM lParam )
 	}
 
 	return DefWindowProc( hWnd,msg,wParam,lParam );
-}
\ No newline at end of file
+}
+#endif
@@ -19,6 +19,56 @@
 *	along with The Chili DirectX Framework.  If not, see <http://www.gnu.org/licenses/>.  *
 ******************************************************************************************/
 #pragma once
+#ifdef CHILI_HEADLESS
+#include "Graphics.h"
+#include "Keyboard.h"
+#include "Mouse.h"
+#include <string>
+
+// virtual-key codes used by the game, normally defined by windows.h
+#define VK_CONTROL 0x11
+
+class HWNDKey
+{
+	friend Graphics::Graphics( HWNDKey& );
+public:
+	HWNDKey( const HWNDKey& ) = delete;
+	HWNDKey& operator=( HWNDKey& ) = delete;
+protected:
+	HWNDKey() = default;
+};
+
+// No window: runs a fixed number of frames and takes its input from the caller
+class MainWindow : public HWNDKey
+{
+public:
+	MainWindow( int nFrames );
+	MainWindow( const MainWindow& ) = delete;
+	MainWindow& operator=( const MainWindow& ) = delete;
+	bool IsActive() const
+	{
+		return true;
+	}
+	bool IsMinimized() const
+	{
+		return false;
+	}
+	void ShowMessageBox( const std::wstring& title,const std::wstring& message ) const;
+	void Kill()
+	{
+		nFramesLeft = 0;
+	}
+	// returns false once all frames have run
+	bool ProcessMessage();
+	void PressLeft( int x,int y );
+	void PressRight( int x,int y );
+public:
+	Keyboard kbd;
+	Mouse mouse;
+private:
+	int nFramesLeft;
+};
+#else
 #include "ChiliWin.h"
 #include "Graphics.h"
 #include "Keyboard.h"
@@ -78,4 +128,5 @@ private:
 	static constexpr wchar_t* wndClassName = L"Chili DirectX Framework Window";
 	HINSTANCE hInst = nullptr;
 	std::wstring args;
-};
\ No newline at end of file
+};
+#endif
@@ -0,0 +1,85 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include "ChiliWin.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+	const HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > 0)
+	{
+		const HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		if (hMapping != nullptr)
+		{
+			pData = static_cast<unsigned char*>(MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0));
+			if (pData != nullptr)
+			{
+				size = size_t(fileSize.QuadPart);
+			}
+			// The view keeps the mapping alive
+			CloseHandle(hMapping);
+		}
+	}
+	CloseHandle(hFile);
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void* const p = mmap(nullptr, size_t(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (p != MAP_FAILED)
+		{
+			pData = static_cast<unsigned char*>(p);
+			size = size_t(info.st_size);
+		}
+	}
+	// The mapping keeps the file alive
+	close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	if (pData != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(pData);
+#else
+		munmap(pData, size);
+#endif
+	}
+}
+
+bool MappedFile::IsOpen() const
+{
+	return pData != nullptr;
+}
+
+unsigned char* MappedFile::GetData() const
+{
+	return pData;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return size;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+// Whole file mapped into memory copy-on-write: the pages are read from the file on
+// first touch and writes to them stay private to this process, the file never changes
+class MappedFile
+{
+public:
+	MappedFile(const std::string& path);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+	// False when the file could not be opened or mapped, or is empty
+	bool IsOpen() const;
+	// Page aligned
+	unsigned char* GetData() const;
+	size_t GetSize() const;
+
+private:
+	unsigned char* pData = nullptr;
+	size_t size = 0;
+};
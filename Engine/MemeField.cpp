@@ -1,142 +1,134 @@
 #include "MemeField.h"
 #include <assert.h>
-#include <random>
+#include "Xoshiro256.h"
 #include "Vei2.h"
 #include "SpriteCodex.h"
 #include <algorithm>
 
 void MemeField::Tile::SpawnMeme()
 {
-	assert( !hasMeme );
-	hasMeme = true;
+	assert( !HasMeme() );
+	bits |= memeBit;
 }
 
 bool MemeField::Tile::HasMeme() const
 {
-	return hasMeme;
+	return (bits & memeBit) != 0;
 }
 
 void MemeField::Tile::Draw( const Vei2& screenPos,MemeField::State fieldState,Graphics& gfx ) const
 {
+	SpriteCodex::DrawTile( GetVariant( fieldState ),screenPos,gfx );
+}
+
+SpriteCodex::TileVariant MemeField::Tile::GetVariant( MemeField::State fieldState ) const
+{
+	const int nNeighborMemes = bits & countMask;
 	if( fieldState != MemeField::State::Fucked )
 	{
-		switch( state )
+		switch( GetState() )
 		{
 		case State::Hidden:
-			SpriteCodex::DrawTileButton( screenPos,gfx );
-			break;
+			return SpriteCodex::TileVariant::Button;
 		case State::Flagged:
-			SpriteCodex::DrawTileButton( screenPos,gfx );
-			SpriteCodex::DrawTileFlag( screenPos,gfx );
-			break;
-		case State::Revealed:
+			return SpriteCodex::TileVariant::Flagged;
+		default:
 			if( !HasMeme() )
 			{
-				SpriteCodex::DrawTileNumber( screenPos,nNeighborMemes,gfx );
-			}
-			else
-			{
-				SpriteCodex::DrawTileBomb( screenPos,gfx );
+				return SpriteCodex::TileVariant( nNeighborMemes );
 			}
-			break;
+			return SpriteCodex::TileVariant::Bomb;
 		}
 	}
 	else // we are fucked
 	{
-		switch( state )
+		switch( GetState() )
 		{
 		case State::Hidden:
-			if( HasMeme() )
-			{
-				SpriteCodex::DrawTileBomb( screenPos,gfx );
-			}
-			else
-			{
-				SpriteCodex::DrawTileButton( screenPos,gfx );
-			}
-			break;
+			return HasMeme() ? SpriteCodex::TileVariant::Bomb : SpriteCodex::TileVariant::Button;
 		case State::Flagged:
-			if( HasMeme() )
-			{
-				SpriteCodex::DrawTileBomb( screenPos,gfx );
-				SpriteCodex::DrawTileFlag( screenPos,gfx );
-			}
-			else
-			{
-				SpriteCodex::DrawTileBomb( screenPos,gfx );
-				SpriteCodex::DrawTileCross( screenPos,gfx );
-			}
-			break;
-		case State::Revealed:
+			return HasMeme() ? SpriteCodex::TileVariant::BombFlagged : SpriteCodex::TileVariant::BombCrossed;
+		default:
 			if( !HasMeme() )
 			{
-				SpriteCodex::DrawTileNumber( screenPos,nNeighborMemes,gfx );
-			}
-			else
-			{
-				SpriteCodex::DrawTileBombRed( screenPos,gfx );
+				return SpriteCodex::TileVariant( nNeighborMemes );
 			}
-			break;
+			return SpriteCodex::TileVariant::BombRed;
 		}
 	}
 }
 
 void MemeField::Tile::Reveal()
 {
-	assert( state == State::Hidden );
-	state = State::Revealed;
+	assert( GetState() == State::Hidden );
+	SetState( State::Revealed );
 }
 
 bool MemeField::Tile::IsRevealed() const
 {
-	return state == State::Revealed;
+	return GetState() == State::Revealed;
 }
 
 void MemeField::Tile::ToggleFlag()
 {
 	assert( !IsRevealed() );
-	if( state == State::Hidden )
+	if( GetState() == State::Hidden )
 	{
-		state = State::Flagged;
+		SetState( State::Flagged );
 	}
 	else
 	{
-		state = State::Hidden;
+		SetState( State::Hidden );
 	}
 }
 
 bool MemeField::Tile::IsFlagged() const
 {
-	return state == State::Flagged;
+	return GetState() == State::Flagged;
 }
 
 bool MemeField::Tile::HasNoNeighborMemes() const
 {
-	return nNeighborMemes == 0;
+	return (bits & countMask) == 0;
 }
 
 void MemeField::Tile::SetNeighborMemeCount( int memeCount )
 {
-	assert( nNeighborMemes == -1 );
-	nNeighborMemes = memeCount;
+	assert( (bits & countMask) == countUnset );
+	assert( memeCount >= 0 && memeCount <= 8 );
+	bits = (unsigned char)((bits & ~countMask) | memeCount);
+}
+
+MemeField::Tile::State MemeField::Tile::GetState() const
+{
+	return State( (bits & stateMask) >> stateShift );
+}
+
+void MemeField::Tile::SetState( State state )
+{
+	bits = (unsigned char)((bits & ~stateMask) | (int( state ) << stateShift));
 }
 
 MemeField::MemeField( const Vei2& center,int nMemes )
+	:
+	MemeField( center,nMemes,Xoshiro256::MakeRandomSeed() )
+{
+}
+
+MemeField::MemeField( const Vei2& center,int nMemes,uint64_t seed )
 	:
 	topLeft( center - Vei2( width * SpriteCodex::tileSize,height * SpriteCodex::tileSize ) / 2 )
 {
 	assert( nMemes > 0 && nMemes < width * height );
-	std::random_device rd;
-	std::mt19937 rng( rd() );
-	std::uniform_int_distribution<int> xDist( 0,width - 1 );
-	std::uniform_int_distribution<int> yDist( 0,height - 1 );
+	revealQueue.reserve( width * height );
+	Xoshiro256 rng( seed );
 
 	for( int nSpawned = 0; nSpawned < nMemes; ++nSpawned )
 	{
 		Vei2 spawnPos;
 		do
 		{
-			spawnPos = { xDist( rng ),yDist( rng ) };
+			spawnPos = { int( rng.Bounded( width ) ),int( rng.Bounded( height ) ) };
 		}
 		while( TileAt( spawnPos ).HasMeme() );
 
@@ -154,8 +146,8 @@ MemeField::MemeField( const Vei2& center,int nMemes )
 
 void MemeField::Draw( Graphics& gfx ) const
 {
+	// cached tiles are opaque, the field needs no base color fill under them
 	gfx.DrawRect( GetRect().GetExpanded( borderThickness ),borderColor );
-	gfx.DrawRect( GetRect(),SpriteCodex::baseColor );
 	for( Vei2 gridPos = { 0,0 }; gridPos.y < height; gridPos.y++ )
 	{
 		for( gridPos.x = 0; gridPos.x < width; gridPos.x++ )
@@ -216,16 +208,31 @@ void MemeField::RevealTile( const Vei2& gridPos )
 		}
 		else if( tile.HasNoNeighborMemes() )
 		{
-			const int xStart = std::max( 0,gridPos.x - 1 );
-			const int yStart = std::max( 0,gridPos.y - 1 );
-			const int xEnd = std::min( width - 1,gridPos.x + 1 );
-			const int yEnd = std::min( height - 1,gridPos.y + 1 );
-
-			for( Vei2 gridPos = { xStart,yStart }; gridPos.y <= yEnd; gridPos.y++ )
+			// explicit worklist flood fill, tiles are revealed when queued so each is queued once
+			revealQueue.clear();
+			revealQueue.push_back( gridPos );
+			for( size_t head = 0; head < revealQueue.size(); head++ )
 			{
-				for( gridPos.x = xStart; gridPos.x <= xEnd; gridPos.x++ )
+				const Vei2 pos = revealQueue[head];
+				const int xStart = std::max( 0,pos.x - 1 );
+				const int yStart = std::max( 0,pos.y - 1 );
+				const int xEnd = std::min( width - 1,pos.x + 1 );
+				const int yEnd = std::min( height - 1,pos.y + 1 );
+
+				for( Vei2 neighborPos = { xStart,yStart }; neighborPos.y <= yEnd; neighborPos.y++ )
 				{
-					RevealTile( gridPos );
+					for( neighborPos.x = xStart; neighborPos.x <= xEnd; neighborPos.x++ )
+					{
+						Tile& neighbor = TileAt( neighborPos );
+						if( !neighbor.IsRevealed() && !neighbor.IsFlagged() )
+						{
+							neighbor.Reveal();
+							if( neighbor.HasNoNeighborMemes() )
+							{
+								revealQueue.push_back( neighborPos );
+							}
+						}
+					}
 				}
 			}
 		}
@@ -271,13 +278,12 @@ int MemeField::CountNeighborMemes( const Vei2 & gridPos )
 
 bool MemeField::GameIsWon() const
 {
+	// No early out: a branch-free pass over the packed bytes lets the compiler
+	// check 16 tiles per SSE2 register
+	bool won = true;
 	for( const Tile& t : field )
 	{
-		if( (t.HasMeme() && !t.IsFlagged()) ||
-			(!t.HasMeme() && !t.IsRevealed()) )
-		{
-			return false;
-		}
+		won &= t.HasMeme() ? t.IsFlagged() : t.IsRevealed();
 	}
-	return true;
+	return won;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "Graphics.h"
 #include "Sound.h"
+#include "SpriteCodex.h"
+#include <vector>
+#include <stdint.h>
 
 class MemeField
 {
@@ -13,10 +16,12 @@ public:
 		Memeing
 	};
 private:
+	// Whole tile packed in one byte: bits 0-3 hold the neighbor meme count (15 until
+	// it is set), bit 4 the meme and bits 5-6 the state
 	class Tile
 	{
 	public:
-		enum class State
+		enum class State : unsigned char
 		{
 			Hidden,
 			Flagged,
@@ -33,12 +38,21 @@ private:
 		bool HasNoNeighborMemes() const;
 		void SetNeighborMemeCount( int memeCount );
 	private:
-		State state = State::Hidden;
-		bool hasMeme = false;
-		int nNeighborMemes = -1;
+		SpriteCodex::TileVariant GetVariant( MemeField::State fieldState ) const;
+		State GetState() const;
+		void SetState( State state );
+	private:
+		static constexpr unsigned char countMask = 0x0F;
+		static constexpr unsigned char countUnset = 0x0F;
+		static constexpr unsigned char memeBit = 0x10;
+		static constexpr int stateShift = 5;
+		static constexpr unsigned char stateMask = 0x60;
+		unsigned char bits = countUnset;
 	};
+	static_assert( sizeof( Tile ) == 1,"Tile should pack into one byte" );
 public:
 	MemeField( const Vei2& center,int nMemes );
+	MemeField( const Vei2& center,int nMemes,uint64_t seed );
 	void Draw( Graphics& gfx ) const;
 	RectI GetRect() const;
 	void OnRevealClick( const Vei2& screenPos );
@@ -60,4 +74,5 @@ private:
 	Vei2 topLeft;
 	State state = State::Memeing;
 	Tile field[width * height];
+	std::vector<Vei2> revealQueue;
 };
\ No newline at end of file
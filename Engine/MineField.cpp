@@ -1,321 +1,1238 @@
 #include "MineField.h"
-#include "SpriteCodex.h"
-#include "Vei2.h"
 #include <assert.h>
-#include <random>
+#include "Xoshiro256.h"
+#include "MappedFile.h"
+#include "Varint.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
 
-void MineField::Tile::SpawnBomb()
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINEFIELD_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+MineField::MineField(int nMines)
+	:MineField(defaultWidth, defaultHeight, nMines)
 {
-	// Only spawn a mine if there is no mine
-	assert(!hasBomb);
+}
 
-	hasBomb = true;
+MineField::MineField(int width, int height, int nMines)
+	:MineField(width, height, nMines, Xoshiro256::MakeRandomSeed())
+{
 }
 
-bool MineField::Tile::HasBomb() const
+MineField::MineField(int width, int height, int nMines, uint64_t seed)
+	:MineField(width, height, nMines, seed, nullptr)
 {
-	return hasBomb;
 }
 
-void MineField::Tile::Draw(const Vei2 screenPos, MineField::State state, Graphics & gfx) const
+MineField::MineField(int width, int height, int nMines, uint64_t seed, const Vei2& safeStart)
+	:MineField(width, height, nMines, seed, &safeStart)
 {
-	if (state != MineField::State::Fucked)
+}
+
+MineField::MineField(int width, int height, int nMines, uint64_t seed, const Vei2* pSafeStart)
+	:width(width),
+	height(height),
+	nMines(nMines),
+	seed(seed),
+	nHiddenSafeTiles(width * height - nMines),
+	mines(width * height),
+	revealed(width * height),
+	flagged(width * height),
+	neighborCounts(width * height)
+{
+	// nMines only can be more than 0 and less than the mine field size
+	assert(width > 0 && height > 0);
+	assert(nMines > 0 && (nMines < width * height));
+
+	PlaceMines(seed, pSafeStart);
+	CountNeighborBombs(mines, width, height, neighborCounts.GetOwnedData());
+	if (width * height >= openingThreshold)
 	{
-		switch (stateTile)
+		LabelOpenings();
+	}
+}
+
+// Snapshot layout: this header, then the mine, revealed and flagged planes as 64-bit
+// words and the neighbor counts, one byte per tile. The header size keeps the planes
+// 8-byte aligned in the mapped file
+struct SnapshotHeader
+{
+	char magic[4];
+	uint32_t version;
+	int32_t width;
+	int32_t height;
+	int32_t nMines;
+	int32_t state;
+	uint64_t seed;
+};
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "Snapshot planes must stay 8-byte aligned");
+
+static const char snapshotMagic[4] = { 'M','F','S','N' };
+// Bump when the layout changes, older snapshots are then refused by Load()
+static constexpr uint32_t snapshotVersion = 2;
+
+static uint64_t* SnapshotPlane(const MappedFile& snapshot, int nTiles, int plane)
+{
+	uint64_t* const planes = reinterpret_cast<uint64_t*>(snapshot.GetData() + sizeof(SnapshotHeader));
+	return planes + size_t(plane) * size_t((nTiles + 63) / 64);
+}
+
+static const unsigned char* SnapshotCounts(const MappedFile& snapshot, int nTiles)
+{
+	return reinterpret_cast<const unsigned char*>(SnapshotPlane(snapshot, nTiles, 3));
+}
+
+MineField::MineField(std::shared_ptr<MappedFile> pSnapshot, int width, int height, int nMines, uint64_t seed, State state,
+	int nRevealedSafeTiles, int nFlaggedMines)
+	:width(width),
+	height(height),
+	state(state),
+	nMines(nMines),
+	seed(seed),
+	nHiddenSafeTiles(width * height - nMines - nRevealedSafeTiles),
+	nFlaggedMines(nFlaggedMines),
+	mines(width * height, SnapshotPlane(*pSnapshot, width * height, 0)),
+	revealed(width * height, SnapshotPlane(*pSnapshot, width * height, 1)),
+	flagged(width * height, SnapshotPlane(*pSnapshot, width * height, 2)),
+	neighborCounts(SnapshotCounts(*pSnapshot, width * height)),
+	pSnapshot(std::move(pSnapshot))
+{
+	if (width * height >= openingThreshold)
+	{
+		LabelOpenings();
+	}
+}
+
+bool MineField::Save(const std::string& path) const
+{
+	SnapshotHeader header;
+	std::memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+	header.version = snapshotVersion;
+	header.width = width;
+	header.height = height;
+	header.nMines = nMines;
+	header.state = int32_t(state);
+	header.seed = seed;
+
+	FILE* const pFile = std::fopen(path.c_str(), "wb");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	const size_t planeSize = size_t(mines.GetWordCount()) * sizeof(uint64_t);
+	const bool written = std::fwrite(&header, sizeof(header), 1, pFile) == 1 &&
+		std::fwrite(mines.GetWords(), 1, planeSize, pFile) == planeSize &&
+		std::fwrite(revealed.GetWords(), 1, planeSize, pFile) == planeSize &&
+		std::fwrite(flagged.GetWords(), 1, planeSize, pFile) == planeSize &&
+		std::fwrite(neighborCounts.GetData(), 1, size_t(width * height), pFile) == size_t(width * height);
+	return std::fclose(pFile) == 0 && written;
+}
+
+std::unique_ptr<MineField> MineField::Load(const std::string& path)
+{
+	std::shared_ptr<MappedFile> pSnapshot = std::make_shared<MappedFile>(path);
+	if (!pSnapshot->IsOpen() || pSnapshot->GetSize() < sizeof(SnapshotHeader))
+	{
+		return nullptr;
+	}
+
+	SnapshotHeader header;
+	std::memcpy(&header, pSnapshot->GetData(), sizeof(header));
+	if (std::memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0 ||
+		header.version != snapshotVersion ||
+		header.width <= 0 || header.height <= 0 ||
+		int64_t(header.width) * header.height > INT32_MAX - 63 ||
+		header.state < int32_t(State::Fucked) || header.state > int32_t(State::Mineming))
+	{
+		return nullptr;
+	}
+
+	const int nTiles = header.width * header.height;
+	const size_t planeSize = size_t((nTiles + 63) / 64) * sizeof(uint64_t);
+	if (header.nMines <= 0 || header.nMines >= nTiles ||
+		pSnapshot->GetSize() != sizeof(SnapshotHeader) + 3 * planeSize + size_t(nTiles))
+	{
+		return nullptr;
+	}
+
+	// Bits past the last tile must be clear, the running counts are taken a word at a time
+	if (nTiles % 64 != 0)
+	{
+		const uint64_t pastLastTile = ~uint64_t(0) << (nTiles % 64);
+		for (int plane = 0; plane < 3; plane++)
 		{
-		case MineField::Tile::StateTile::Hidden:
-			SpriteCodex::DrawTileButton(screenPos, gfx);
-			break;
-		case MineField::Tile::StateTile::Flagged:
-			SpriteCodex::DrawTileButton(screenPos, gfx);
-			SpriteCodex::DrawTileFlag(screenPos, gfx);
-			break;
-		case MineField::Tile::StateTile::Revealed:
-			if (!hasBomb)
+			if ((SnapshotPlane(*pSnapshot, nTiles, plane)[nTiles / 64] & pastLastTile) != 0u)
 			{
-				SpriteCodex::DrawTileNumber(screenPos, nNeighborBombs, gfx);
+				return nullptr;
 			}
-			else
+		}
+	}
+
+	// Running counts for the win check, a word at a time. A revealed tile is never
+	// flagged, and no mine is revealed while the game is still running
+	const BitPlane minePlane(nTiles, SnapshotPlane(*pSnapshot, nTiles, 0));
+	const uint64_t* const revealedWords = SnapshotPlane(*pSnapshot, nTiles, 1);
+	const uint64_t* const flaggedWords = SnapshotPlane(*pSnapshot, nTiles, 2);
+	const bool isRunning = State(header.state) == State::Mineming;
+	int nRevealedSafeTiles = 0;
+	int nFlaggedMines = 0;
+	for (int w = 0; w < minePlane.GetWordCount(); w++)
+	{
+		const uint64_t mineWord = minePlane.GetWord(w);
+		if ((revealedWords[w] & flaggedWords[w]) != 0u ||
+			(isRunning && (revealedWords[w] & mineWord) != 0u))
+		{
+			return nullptr;
+		}
+		nRevealedSafeTiles += BitPlane::PopCount(revealedWords[w] & ~mineWord);
+		nFlaggedMines += BitPlane::PopCount(flaggedWords[w] & mineWord);
+	}
+
+	if (minePlane.Count() != header.nMines ||
+		!CountsMatchMines(minePlane, header.width, header.height, SnapshotCounts(*pSnapshot, nTiles)))
+	{
+		return nullptr;
+	}
+
+	return std::unique_ptr<MineField>(new MineField(std::move(pSnapshot), header.width, header.height,
+		header.nMines, header.seed, State(header.state), nRevealedSafeTiles, nFlaggedMines));
+}
+
+int MineField::GetMaxMines(int width, int height, const Vei2* pSafeStart)
+{
+	if (pSafeStart == nullptr)
+	{
+		return width * height - 1;
+	}
+	const int nSafe = (std::min(pSafeStart->x + 1, width - 1) - std::max(pSafeStart->x - 1, 0) + 1) *
+		(std::min(pSafeStart->y + 1, height - 1) - std::max(pSafeStart->y - 1, 0) + 1);
+	return width * height - nSafe;
+}
+
+void MineField::PlaceMines(uint64_t seed, const Vei2* pSafeStart)
+{
+	// Tiles kept free of mines, in increasing index order
+	int excluded[9];
+	int nExcluded = 0;
+	if (pSafeStart != nullptr)
+	{
+		assert(IsInside(*pSafeStart));
+		for (int y = std::max(0, pSafeStart->y - 1); y <= std::min(height - 1, pSafeStart->y + 1); y++)
+		{
+			for (int x = std::max(0, pSafeStart->x - 1); x <= std::min(width - 1, pSafeStart->x + 1); x++)
 			{
-				SpriteCodex::DrawTileBomb(screenPos, gfx);
+				excluded[nExcluded++] = IndexOf({ x,y });
 			}
+		}
+	}
+	assert(nMines <= GetMaxMines(width, height, pSafeStart));
 
-			break;
-		default:
-			break;
+	// Candidate c is the c-th tile that is not excluded
+	auto tileOf = [&excluded, nExcluded](int c)
+	{
+		for (int e = 0; e < nExcluded && excluded[e] <= c; e++)
+		{
+			c++;
 		}
-	}else // We are fucked
+		return c;
+	};
+
+	// The same seed always gives the same field
+	Xoshiro256 rng(seed);
+
+	// Pick the mine tiles with Floyd's sampling algorithm: one draw per mine and no
+	// redraws, so generation time does not depend on the mine density.
+	// The mine plane itself is the set of tiles picked so far
+	const int nCandidates = width * height - nExcluded;
+	for (int last = nCandidates - nMines; last < nCandidates; last++)
 	{
-		switch (stateTile)
+		const int pick = tileOf(int(rng.Bounded(uint32_t(last) + 1u)));
+
+		// Take the newest candidate tile if the random pick is already a mine
+		if (mines.Get(pick))
+		{
+			mines.Set(tileOf(last));
+		}
+		else
 		{
-		case MineField::Tile::StateTile::Hidden:
+			mines.Set(pick);
+		}
+	}
+}
+
+MineField::Event::Event(Type type, const Vei2& gridPos)
+	:type(type),
+	gridPos(gridPos)
+{
+}
 
-			if (HasBomb())
+MineField::Event::Type MineField::Event::GetType() const
+{
+	return type;
+}
+
+Vei2 MineField::Event::GetPos() const
+{
+	return gridPos;
+}
+
+void MineField::SetObserver(Observer* pObserver_in)
+{
+	pObserver = pObserver_in;
+}
+
+void MineField::OnRevealClick(const Vei2& gridPos)
+{
+	if (state == State::Mineming)
+	{
+		assert(IsInside(gridPos));
+
+		moveTiles.clear();
+		RevealTile(gridPos);
+
+		if (state == State::Mineming && GameIsWon())
+		{
+			state = State::Winrar;
+			Notify(Event::Type::Win, gridPos);
+		}
+
+		if (isUndoEnabled && !moveTiles.empty())
+		{
+			RecordMove(IndexOf(gridPos), false);
+		}
+		TrimWorklists();
+	}	
+}
+
+void MineField::OnFlagClick(const Vei2& gridPos)
+{
+	if (state == State::Mineming)
+	{
+		assert(IsInside(gridPos));
+
+		const int i = IndexOf(gridPos);
+		if (!revealed.Get(i))
+		{
+			ToggleFlag(i);
+
+			Notify(flagged.Get(i) ? Event::Type::Flag : Event::Type::Unflag, gridPos);
+
+			// Flagging the last bomb can also win the game
+			if (GameIsWon())
 			{
-				SpriteCodex::DrawTileBomb(screenPos, gfx);
+				state = State::Winrar;
+				Notify(Event::Type::Win, gridPos);
 			}
-			else
+
+			if (isUndoEnabled)
 			{
-				SpriteCodex::DrawTileButton(screenPos, gfx);
+				RecordMove(i, true);
 			}
+		}
+	}
+}
 
-			
-			break;
-		case MineField::Tile::StateTile::Flagged:
-			if (HasBomb())
+void MineField::ToggleFlag(int i)
+{
+	flagged.Toggle(i);
+
+	// Keep the count of correctly flagged bombs for the win check
+	if (mines.Get(i))
+	{
+		nFlaggedMines += flagged.Get(i) ? 1 : -1;
+	}
+
+	if (!openingStart.empty())
+	{
+		AddOpeningBlock(i, flagged.Get(i) ? 1 : -1);
+	}
+}
+
+void MineField::RecordMove(int tile, bool isFlag)
+{
+	// A new move replaces the moves that were undone
+	if (nApplied < journal.size())
+	{
+		journalRuns.resize(journal[nApplied].runsStart);
+		journal.resize(nApplied);
+	}
+
+	Move move;
+	move.tile = tile;
+	move.isFlag = isFlag;
+	move.stateAfter = state;
+	// Revealed bombs were never counted as hidden safe tiles, a chord can reveal several
+	move.nSafeRevealed = 0;
+	for (int t : moveTiles)
+	{
+		move.nSafeRevealed += mines.Get(t) ? 0 : 1;
+	}
+	move.runsStart = journalRuns.size();
+
+	// Openings are listed in sweep order, not by index
+	std::sort(moveTiles.begin(), moveTiles.end());
+	int runEnd = 0;
+	for (size_t k = 0; k < moveTiles.size(); )
+	{
+		const int runStart = moveTiles[k];
+		int length = 1;
+		for (k++; k < moveTiles.size() && moveTiles[k] == runStart + length; k++)
+		{
+			length++;
+		}
+		WriteVarint(journalRuns, uint64_t(runStart - runEnd));
+		WriteVarint(journalRuns, uint64_t(length));
+		runEnd = runStart + length;
+	}
+
+	journal.push_back(move);
+	nApplied = journal.size();
+	moveTiles.clear();
+}
+
+void MineField::TrimWorklists()
+{
+	// A big reveal leaves its worklists as large as the area it opened, give that back
+	if (moveTiles.capacity() > maxKeptWorklist)
+	{
+		std::vector<int>().swap(moveTiles);
+	}
+	if (revealQueue.capacity() > maxKeptWorklist)
+	{
+		std::vector<int>().swap(revealQueue);
+	}
+}
+
+void MineField::SetMoveRevealed(size_t m, bool isRevealed)
+{
+	const Move& move = journal[m];
+	const unsigned char* p = journalRuns.data() + move.runsStart;
+	const unsigned char* const end = journalRuns.data() +
+		(m + 1 < journal.size() ? journal[m + 1].runsStart : journalRuns.size());
+	for (int runEnd = 0; p < end; )
+	{
+		uint64_t gap;
+		uint64_t length;
+		ReadVarint(p, end, gap);
+		ReadVarint(p, end, length);
+		const int runStart = runEnd + int(gap);
+		runEnd = runStart + int(length);
+		for (int t = runStart; t < runEnd; t++)
+		{
+			if (isRevealed)
 			{
-				SpriteCodex::DrawTileBomb(screenPos, gfx);
-				SpriteCodex::DrawTileFlag(screenPos, gfx);
+				revealed.Set(t);
 			}
 			else
 			{
-				SpriteCodex::DrawTileBomb(screenPos, gfx);
-				SpriteCodex::DrawTileCross(screenPos, gfx);
+				revealed.Reset(t);
 			}
-
-			break;
-		case MineField::Tile::StateTile::Revealed:
-			if (!HasBomb())
-			{
-				SpriteCodex::DrawTileNumber(screenPos, nNeighborBombs, gfx);
-			}
-			else
+			if (neighborCounts[t] == 0u && !openingStart.empty())
 			{
-				SpriteCodex::DrawTileBombRed(screenPos, gfx);
+				openingBlockCount[GetOpeningOf(t)] += isRevealed ? 1 : -1;
 			}
-
-			break;
-		default:
-			break;
 		}
 	}
+	nHiddenSafeTiles += isRevealed ? -move.nSafeRevealed : move.nSafeRevealed;
 }
 
-void MineField::Tile::Reveal()
+void MineField::EnableUndo()
 {
-	// Only call this function if state is hidden
-	assert(stateTile == StateTile::Hidden);
-
-	stateTile = StateTile::Revealed;
+	isUndoEnabled = true;
 }
 
-bool MineField::Tile::IsRevealed() const
+bool MineField::CanUndo() const
 {
-	return (stateTile == StateTile::Revealed);
+	return nApplied > 0;
 }
 
-void MineField::Tile::ToggleFlag()
+bool MineField::CanRedo() const
 {
-	// Only call this function if state is hidden
-	assert(!IsRevealed());
+	return nApplied < journal.size();
+}
 
-	if (stateTile == StateTile::Hidden)
-	{
-		stateTile = StateTile::Flagged;
-	}else
+void MineField::Undo()
+{
+	if (CanUndo())
 	{
-		stateTile = StateTile::Hidden;
+		nApplied--;
+		const Move& move = journal[nApplied];
+		if (move.isFlag)
+		{
+			ToggleFlag(move.tile);
+		}
+		else
+		{
+			SetMoveRevealed(nApplied, false);
+		}
+		state = State::Mineming;
 	}
 }
-bool MineField::Tile::IsFlagged() const
+
+void MineField::Redo()
 {
-	return (stateTile == StateTile::Flagged);
+	if (CanRedo())
+	{
+		const Move& move = journal[nApplied];
+		if (move.isFlag)
+		{
+			ToggleFlag(move.tile);
+		}
+		else
+		{
+			SetMoveRevealed(nApplied, true);
+		}
+		state = move.stateAfter;
+		nApplied++;
+	}
 }
 
-bool MineField::Tile::HasNoNeighborBombs() const
+void MineField::RevealTile(const Vei2& gridPos)
 {
-	return (nNeighborBombs == 0);
-}
+	const int i = IndexOf(gridPos);
+
+	if (!revealed.Get(i) && !flagged.Get(i))
+	{
+		revealed.Set(i);
+		if (isUndoEnabled)
+		{
+			moveTiles.push_back(i);
+		}
 
+		if (mines.Get(i))
+		{
+			state = State::Fucked;
+			Notify(Event::Type::Lose, gridPos);
+			return;
+		}
 
-void MineField::Tile::SetNeighborBombCount(int bombCount)
-{
-	// Only if this tile is initialized
-	assert(nNeighborBombs == -1);
+		nHiddenSafeTiles--;
+		Notify(Event::Type::Reveal, gridPos);
 
-	nNeighborBombs = bombCount;
+		if (GetNeighborBombCount(gridPos) == 0)
+		{
+			revealQueue.clear();
+			RevealOpening(i);
+			FloodFill();
+		}
+	}	
 }
 
-MineField::MineField(const Vei2 center, int nMines)
-	:topLeft(center - Vei2(width * SpriteCodex::tileSize, height * SpriteCodex::tileSize) /2)
+void MineField::OnChordClick(const Vei2& gridPos)
 {
-	// nMines only can be more than 0 and less than the mine field size
-	assert(nMines > 0 && (nMines < width * height));
+	if (state == State::Mineming)
+	{
+		assert(IsInside(gridPos));
 
-	std::random_device rd;
-	std::mt19937 rng(rd());
-	// Random position for the mine
-	std::uniform_int_distribution<int> xDist(0, width - 1);
-	std::uniform_int_distribution<int> yDist(0, height - 1);
+		const int i = IndexOf(gridPos);
+		if (!revealed.Get(i) || neighborCounts[i] == 0u)
+		{
+			return;
+		}
 
+		const int xStart = std::max(0, gridPos.x - 1);
+		const int yStart = std::max(0, gridPos.y - 1);
+		const int xEnd = std::min(width - 1, gridPos.x + 1);
+		const int yEnd = std::min(height - 1, gridPos.y + 1);
 
+		int nFlags = 0;
+		for (int y = yStart; y <= yEnd; y++)
+		{
+			for (int x = xStart; x <= xEnd; x++)
+			{
+				nFlags += flagged.Get(y * width + x) ? 1 : 0;
+			}
+		}
+		if (nFlags != neighborCounts[i])
+		{
+			return;
+		}
 
-	// Create mines until the nMines are filled
-	for (int nSpawned = 0; nSpawned < nMines; nSpawned++)
-	{
-		// Spawn positions until the field doesn't have any mines
-		Vei2 spawnPos;
-		do
+		// Reveal every hidden neighbor, a misplaced flag loses the game. Zero tiles
+		// found here all seed the same worklist, so their areas are flooded in one pass
+		moveTiles.clear();
+		revealQueue.clear();
+		for (Vei2 neighborPos = { xStart,yStart }; neighborPos.y <= yEnd; neighborPos.y++)
+		{
+			for (neighborPos.x = xStart; neighborPos.x <= xEnd; neighborPos.x++)
+			{
+				const int n = IndexOf(neighborPos);
+				if (revealed.Get(n) || flagged.Get(n))
+				{
+					continue;
+				}
+
+				revealed.Set(n);
+				if (isUndoEnabled)
+				{
+					moveTiles.push_back(n);
+				}
+				if (mines.Get(n))
+				{
+					if (state == State::Mineming)
+					{
+						state = State::Fucked;
+						Notify(Event::Type::Lose, neighborPos);
+					}
+					continue;
+				}
+
+				nHiddenSafeTiles--;
+				Notify(Event::Type::Reveal, neighborPos);
+				if (neighborCounts[n] == 0u)
+				{
+					RevealOpening(n);
+				}
+			}
+		}
+		FloodFill();
+
+		if (state == State::Mineming && GameIsWon())
+		{
+			state = State::Winrar;
+			Notify(Event::Type::Win, gridPos);
+		}
+
+		if (isUndoEnabled && !moveTiles.empty())
 		{
-			spawnPos = { xDist(rng), yDist(rng) };
+			RecordMove(i, false);
+		}
+		TrimWorklists();
+	}
+}
 
-		} while (TileAt(spawnPos).HasBomb());
-		TileAt(spawnPos).SpawnBomb();
+void MineField::RevealOpening(int i)
+{
+	// Small fields have no openings labeled
+	if (openingStart.empty())
+	{
+		revealQueue.push_back(i);
+		return;
 	}
 
-	for (Vei2 gridPos = { 0,0 }; gridPos.y < height; gridPos.y++)
+	const int opening = GetOpeningOf(i);
+	openingBlockCount[opening]++;
+	if (openingBlockCount[opening] == 1)
 	{
-		for (gridPos.x = 0; gridPos.x < width; gridPos.x++)
+		// Nothing else in the opening is revealed or flagged, so the flood fill would reveal
+		// exactly its zero tiles and their neighbors. Reveal the rows around each of its
+		// runs in one sweep, no neighbor search needed
+		for (int k = openingStart[opening]; k < openingStart[opening + 1]; k++)
 		{
-			TileAt(gridPos).SetNeighborBombCount(CountNeighborBombs(gridPos));
+			const ZeroRun& run = openingRuns[k];
+			const int y = run.first / width;
+			const int xStart = std::max(0, run.first - y * width - 1);
+			const int xEnd = std::min(width - 1, run.last - y * width + 1);
+			for (int ny = std::max(0, y - 1); ny <= std::min(height - 1, y + 1); ny++)
+			{
+				for (int t = ny * width + xStart; t <= ny * width + xEnd; t++)
+				{
+					if (!revealed.Get(t))
+					{
+						revealed.Set(t);
+						if (isUndoEnabled)
+						{
+							moveTiles.push_back(t);
+						}
+						nHiddenSafeTiles--;
+						openingBlockCount[opening] += neighborCounts[t] == 0u ? 1 : 0;
+						NotifyReveal(t);
+					}
+				}
+			}
 		}
 	}
+	else
+	{
+		revealQueue.push_back(i);
+	}
 }
 
-void MineField::Draw(Graphics& gfx) const
+void MineField::FloodFill()
 {
-	gfx.DrawRect(GetRect().GetExpanded(borderThickness), borderColor);
+	// Flood fill the open area with an explicit worklist instead of recursion.
+	// Tiles are marked revealed when they are queued, so every tile is queued
+	// at most once and the queue never grows past the field size
+	for (size_t head = 0; head < revealQueue.size(); head++)
+	{
+		const Vei2 pos = { revealQueue[head] % width, revealQueue[head] / width };
 
-	gfx.DrawRect(GetRect(), SpriteCodex::baseColor);
+		// Set the boundaries for a gridPos. Maximun 9 tiles covering that gridPos
+		// Taking into account the boundaries of the grid
+		const int xStart = std::max(0, pos.x - 1);
+		const int yStart = std::max(0, pos.y - 1);
+		const int xEnd = std::min(width - 1, pos.x + 1);
+		const int yEnd = std::min(height - 1, pos.y + 1);
 
-	for (Vei2 gridPos = {0,0 }; gridPos.y < height; gridPos.y++)
-	{
-		for (gridPos.x = 0; gridPos.x < width; gridPos.x++)
+		for (Vei2 neighborPos = { xStart,yStart }; neighborPos.y <= yEnd; neighborPos.y++)
 		{
-			TileAt(gridPos).Draw(topLeft + gridPos * SpriteCodex::tileSize, state, gfx);
+			for (neighborPos.x = xStart; neighborPos.x <= xEnd; neighborPos.x++)
+			{
+				const int n = IndexOf(neighborPos);
+
+				// Neighbors of a zero tile are never bombs
+				if (!revealed.Get(n) && !flagged.Get(n))
+				{
+					revealed.Set(n);
+					if (isUndoEnabled)
+					{
+						moveTiles.push_back(n);
+					}
+					nHiddenSafeTiles--;
+					NotifyReveal(n);
+
+					if (neighborCounts[n] == 0u)
+					{
+						revealQueue.push_back(n);
+						if (!openingStart.empty())
+						{
+							openingBlockCount[GetOpeningOf(n)]++;
+						}
+					}
+				}
+			}
 		}
 	}
 }
 
-RectI MineField::GetRect() const
+int MineField::IndexOf(const Vei2& gridPos) const
 {
-	return RectI(topLeft,width *  SpriteCodex::tileSize,height*  SpriteCodex::tileSize);
+	return gridPos.y * width + gridPos.x;
 }
 
-void MineField::OnRevealClick(const Vei2 screenPos)
+bool MineField::IsInside(const Vei2& gridPos) const
 {
-	if (state == State::Mineming)
+	return gridPos.x >= 0 && gridPos.x < width && gridPos.y >= 0 && gridPos.y < height;
+}
+
+int MineField::GetNeighborBombCount(const Vei2& gridPos) const
+{
+	return neighborCounts[IndexOf(gridPos)];
+}
+
+// out[x] = a[x] + b[x] + c[x] for n bytes, 16 bytes per step when SSE2 is available
+static void AddRows(const unsigned char* a, const unsigned char* b, const unsigned char* c,
+	unsigned char* out, int n)
+{
+	int x = 0;
+#ifdef MINEFIELD_USE_SSE2
+	for (; x + 16 <= n; x += 16)
+	{
+		const __m128i sum = _mm_add_epi8(
+			_mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x))),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(c + x)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), sum);
+	}
+#endif
+	for (; x < n; x++)
 	{
-		const Vei2 gridPos = ScreenToGrid(screenPos);
-		assert(gridPos.x >= 0 && gridPos.x < width && gridPos.y >= 0 && gridPos.y < height);
+		out[x] = (unsigned char)(a[x] + b[x] + c[x]);
+	}
+}
 
-		RevealTile(gridPos);
+MineField::NeighborCounts::NeighborCounts(int nTiles)
+	:nTiles(nTiles)
+{
+	if (nTiles > nInlineTiles)
+	{
+		pHeapCounts = std::make_shared<std::vector<unsigned char>>(nTiles);
+		counts = pHeapCounts->data();
+	}
+	else
+	{
+		counts = inlineCounts;
+	}
+}
 
-		if (GameIsWon())
+MineField::NeighborCounts::NeighborCounts(const unsigned char* externalCounts)
+	:counts(externalCounts)
+{
+}
+
+MineField::NeighborCounts::NeighborCounts(const NeighborCounts& src)
+{
+	*this = src;
+}
+
+MineField::NeighborCounts& MineField::NeighborCounts::operator=(const NeighborCounts& rhs)
+{
+	if (this != &rhs)
+	{
+		nTiles = rhs.nTiles;
+		pHeapCounts = rhs.pHeapCounts;
+		// Inline counts are copied, heap counts and views are shared
+		if (rhs.counts == rhs.inlineCounts)
 		{
-			state = State::Winrar;
+			std::copy(rhs.inlineCounts, rhs.inlineCounts + nTiles, inlineCounts);
+			counts = inlineCounts;
 		}
-	}	
+		else
+		{
+			counts = rhs.counts;
+		}
+	}
+	return *this;
 }
 
-void MineField::OnFlagClick(const Vei2 screenPos)
+unsigned char* MineField::NeighborCounts::GetOwnedData()
 {
-	if (state == State::Mineming)
+	assert(counts == inlineCounts || (pHeapCounts != nullptr && pHeapCounts.use_count() == 1));
+	return counts == inlineCounts ? inlineCounts : pHeapCounts->data();
+}
+
+void MineField::CountNeighborBombs(const BitPlane& mines, int width, int height, unsigned char* counts)
+{
+	// Fill in all neighbor counts in one pass, split across cores for very large fields
+	if (width * height >= parallelThreshold)
+	{
+		CountNeighborBombsParallel(mines, width, height, counts);
+	}
+	else
+	{
+		CountNeighborBombRows(mines, width, height, 0, height, counts);
+	}
+}
+
+void MineField::SumMineRow(const BitPlane& mines, int width, int height, int y, unsigned char* paddedRow,
+	unsigned char* out)
+{
+	// Horizontal 3-tile sums of row y, zero for rows outside the field. paddedRow holds
+	// width + 2 bytes whose first and last stay 0
+	if (y < 0 || y >= height)
 	{
-		const Vei2 gridPos = ScreenToGrid(screenPos);
-		assert(gridPos.x >= 0 && gridPos.x < width && gridPos.y >= 0 && gridPos.y < height);
+		std::fill(out, out + width, (unsigned char)0u);
+		return;
+	}
 
-		Tile& tile = TileAt(gridPos);
-		if (!tile.IsRevealed())
+	for (int x = 0; x < width; x++)
+	{
+		paddedRow[x + 1] = mines.Get(y * width + x) ? 1u : 0u;
+	}
+	AddRows(&paddedRow[0], &paddedRow[1], &paddedRow[2], out, width);
+}
+
+void MineField::CountNeighborBombRows(const BitPlane& mines, int width, int height, int yStart, int yEnd,
+	unsigned char* counts)
+{
+	// Separable 3x3 box sum over the mine plane: every row is unpacked to one byte
+	// per tile with a zero tile of padding on both sides, summed horizontally, and
+	// three horizontal sums are added up for the final counts.
+	// The sum includes the tile itself, which only matters for bomb tiles, and
+	// those never show a number
+	// The padded row and three rows of sums, on the stack unless the rows are very wide
+	unsigned char stackRows[4 * maxStackRowWidth + 2];
+	std::vector<unsigned char> heapRows;
+	unsigned char* paddedRow = stackRows;
+	if (width > maxStackRowWidth)
+	{
+		heapRows.resize(4 * size_t(width) + 2);
+		paddedRow = heapRows.data();
+	}
+	paddedRow[0] = 0u;
+	paddedRow[width + 1] = 0u;
+
+	unsigned char* above = paddedRow + width + 2;
+	unsigned char* current = above + width;
+	unsigned char* below = current + width;
+	SumMineRow(mines, width, height, yStart - 1, paddedRow, above);
+	SumMineRow(mines, width, height, yStart, paddedRow, current);
+
+	for (int y = yStart; y < yEnd; y++)
+	{
+		SumMineRow(mines, width, height, y + 1, paddedRow, below);
+		AddRows(above, current, below, counts + size_t(y) * size_t(width), width);
+
+		// Slide the window one row down
+		std::swap(above, current);
+		std::swap(current, below);
+	}
+}
+
+void MineField::CountNeighborBombsParallel(const BitPlane& mines, int width, int height, unsigned char* counts)
+{
+	// Every band reads its halo rows (the row above and below the band) straight from
+	// the shared mine plane and only writes its own rows of counts, so the bands need no
+	// synchronization and the result is identical to counting all rows in one band
+	const int nThreads = std::max(1, std::min(int(std::thread::hardware_concurrency()), height));
+	const int bandHeight = (height + nThreads - 1) / nThreads;
+
+	std::vector<std::thread> workers;
+	workers.reserve(nThreads - 1);
+	for (int yStart = bandHeight; yStart < height; yStart += bandHeight)
+	{
+		const int yEnd = std::min(height, yStart + bandHeight);
+		workers.emplace_back([&mines, width, height, yStart, yEnd, counts]()
 		{
-			TileAt(gridPos).ToggleFlag();
-		}
+			CountNeighborBombRows(mines, width, height, yStart, yEnd, counts);
+		});
+	}
+
+	// The calling thread takes the first band
+	CountNeighborBombRows(mines, width, height, 0, std::min(height, bandHeight), counts);
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
 	}
 }
 
-void MineField::RevealTile(const Vei2& gridPos)
+bool MineField::CountsMatchMines(const BitPlane& minePlane, int width, int height, const unsigned char* counts)
 {
-	Tile& tile = TileAt(gridPos);
+	// Recounts row by row with the same separable pass as CountNeighborBombRows() and
+	// compares every row, so counts that were swapped around or shifted are caught too
+	unsigned char stackRows[5 * maxStackRowWidth + 2];
+	std::vector<unsigned char> heapRows;
+	unsigned char* paddedRow = stackRows;
+	if (width > maxStackRowWidth)
+	{
+		heapRows.resize(5 * size_t(width) + 2);
+		paddedRow = heapRows.data();
+	}
+	paddedRow[0] = 0u;
+	paddedRow[width + 1] = 0u;
+
+	unsigned char* above = paddedRow + width + 2;
+	unsigned char* current = above + width;
+	unsigned char* below = current + width;
+	unsigned char* const expected = below + width;
+	std::fill(above, above + width, (unsigned char)0u);
+	SumMineRow(minePlane, width, height, 0, paddedRow, current);
+	for (int y = 0; y < height; y++)
+	{
+		SumMineRow(minePlane, width, height, y + 1, paddedRow, below);
+		AddRows(above, current, below, expected, width);
+		if (std::memcmp(expected, counts + size_t(y) * size_t(width), size_t(width)) != 0)
+		{
+			return false;
+		}
 
-	if (!tile.IsRevealed() && !tile.IsFlagged())
+		std::swap(above, current);
+		std::swap(current, below);
+	}
+	return true;
+}
+
+int MineField::LabelZeroRuns(const unsigned char* counts, int width, int height, std::vector<ZeroRun>& runs,
+	std::vector<int>& openingOfRun)
+{
+	// Union-find over the runs in one raster pass: every run is linked to the runs of the
+	// row above that it touches, diagonally included. A set's root is always its first
+	// run, openingOfRun holds the parent of each run until the openings are numbered
+	runs.clear();
+	openingOfRun.clear();
+	auto find = [&openingOfRun](int r)
 	{
-		tile.Reveal();
+		while (openingOfRun[r] != r)
+		{
+			openingOfRun[r] = openingOfRun[openingOfRun[r]];
+			r = openingOfRun[r];
+		}
+		return r;
+	};
 
-		if (tile.HasBomb())
+	// Zero tiles of the current row as bits, found 16 at a time when SSE2 is available.
+	// Runs are then read off the words, whether a tile is zero is random on a random
+	// field and a branch per tile would mispredict a lot
+	const int nRowWords = (width + 63) / 64;
+	std::vector<uint64_t> zeroBits(nRowWords);
+	auto findRowZeros = [&zeroBits, width](const unsigned char* row)
+	{
+		std::fill(zeroBits.begin(), zeroBits.end(), uint64_t(0));
+		int x = 0;
+#ifdef MINEFIELD_USE_SSE2
+		for (; x + 16 <= width; x += 16)
 		{
-			state = State::Fucked;
-			sndLose.Play();
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+			const uint64_t bits = uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())));
+			zeroBits[x / 64] |= bits << (x % 64);
 		}
-		else if (tile.HasNoNeighborBombs())
+#endif
+		for (; x < width; x++)
 		{
+			zeroBits[x / 64] |= uint64_t(row[x] == 0u ? 1u : 0u) << (x % 64);
+		}
+	};
+	// First tile at or after x whose zero bit is isZero, width if there is none. The bits
+	// past the last tile are clear, so the search for a non-zero tile always stops there
+	auto findNext = [&zeroBits, nRowWords, width](int x, bool isZero)
+	{
+		const uint64_t flip = isZero ? 0u : ~uint64_t(0);
+		int w = x / 64;
+		uint64_t bits = (zeroBits[w] ^ flip) & (~uint64_t(0) << (x % 64));
+		while (bits == 0u)
+		{
+			if (++w >= nRowWords)
+			{
+				return width;
+			}
+			bits = zeroBits[w] ^ flip;
+		}
+		return std::min(width, w * 64 + BitPlane::PopCount((bits & (0u - bits)) - 1u));
+	};
+
+	// Runs of the row above, from the first one that can still touch a run of this row
+	int above = 0;
+	int aboveEnd = 0;
+	for (int y = 0; y < height; y++)
+	{
+		findRowZeros(counts + size_t(y) * size_t(width));
+		const int rowBegin = int(runs.size());
+		for (int x = findNext(0, true); x < width; x = findNext(x + 1, true))
+		{
+			const int xFirst = x;
+			x = findNext(x, false) - 1;
 
-			// Set the boundaries for a gridPos. Maximun 9 tiles covering that gridPos
-			// Taking into account the boundaries of the grid
-			const int xStart = std::max(0, gridPos.x - 1);
-			const int yStart = std::max(0, gridPos.y - 1);
-			const int xEnd = std::min(width - 1, gridPos.x + 1);
-			const int yEnd = std::min(height - 1, gridPos.y + 1);
+			const int r = int(runs.size());
+			runs.push_back({ y * width + xFirst,y * width + x });
+			openingOfRun.push_back(r);
 
-			for (Vei2 gridPos = { xStart,yStart }; gridPos.y <= yEnd; gridPos.y++)
+			// Runs above touch this one when they reach from xFirst - 1 to x + 1
+			const int aboveStart = (y - 1) * width;
+			while (above < aboveEnd && runs[above].last - aboveStart < xFirst - 1)
 			{
-				for (gridPos.x = xStart; gridPos.x <= xEnd; gridPos.x++)
-				{
-					RevealTile(gridPos);					
-				}
+				above++;
+			}
+			for (int a = above; a < aboveEnd && runs[a].first - aboveStart <= x + 1; a++)
+			{
+				const int rootA = find(a);
+				const int rootR = find(r);
+				openingOfRun[std::max(rootA, rootR)] = std::min(rootA, rootR);
 			}
 		}
-	}	
-}
+		above = rowBegin;
+		aboveEnd = int(runs.size());
+	}
 
-MineField::Tile & MineField::TileAt(const Vei2 & gridPos)
-{
-	return field[gridPos.y * width + gridPos.x ];
+	// Parents come before their children, so in run order every parent already holds
+	// its opening when a child reads it. Openings are numbered by their first tile
+	int nOpenings = 0;
+	for (int r = 0; r < int(runs.size()); r++)
+	{
+		openingOfRun[r] = openingOfRun[r] == r ? nOpenings++ : openingOfRun[openingOfRun[r]];
+	}
+	return nOpenings;
 }
 
-const MineField::Tile & MineField::TileAt(const Vei2 & gridPos) const
+void MineField::LabelOpenings()
 {
-	return field[gridPos.y * width + gridPos.x];
+	// The runs of every opening are counted and placed in tile order, then every zero
+	// tile gets the opening of its run. Labeling takes 12 bytes per run, a few per tile,
+	// only while it runs
+	const int nTiles = width * height;
+	std::vector<ZeroRun> runs;
+	std::vector<int> openingOfRun;
+	const int nOpenings = LabelZeroRuns(neighborCounts.GetData(), width, height, runs, openingOfRun);
+
+	openingStart.assign(nOpenings + 1, 0);
+	for (int opening : openingOfRun)
+	{
+		openingStart[opening + 1]++;
+	}
+	for (int o = 0; o < nOpenings; o++)
+	{
+		openingStart[o + 1] += openingStart[o];
+	}
+	openingRuns.resize(runs.size());
+	openingRuns.shrink_to_fit();
+	std::vector<int> next(openingStart.begin(), openingStart.end() - 1);
+	int nZeroTiles = 0;
+	for (size_t r = 0; r < runs.size(); r++)
+	{
+		openingRuns[next[openingOfRun[r]]++] = runs[r];
+		nZeroTiles += runs[r].last - runs[r].first + 1;
+	}
+
+	zeroTiles = BitPlane(nTiles);
+	openingOfZero.resize(nZeroTiles);
+	openingOfZero.shrink_to_fit();
+	int z = 0;
+	for (size_t r = 0; r < runs.size(); r++)
+	{
+		for (int t = runs[r].first; t <= runs[r].last; t++)
+		{
+			zeroTiles.Set(t);
+		}
+		std::fill_n(openingOfZero.begin() + z, runs[r].last - runs[r].first + 1, openingOfRun[r]);
+		z += runs[r].last - runs[r].first + 1;
+	}
+	zeroRank.resize(zeroTiles.GetWordCount());
+	for (int w = 0, rank = 0; w < zeroTiles.GetWordCount(); w++)
+	{
+		zeroRank[w] = rank;
+		rank += BitPlane::PopCount(zeroTiles.GetWord(w));
+	}
+
+	// Flags and revealed zero tiles already in each opening, only those tiles are visited
+	openingBlockCount.assign(nOpenings, 0);
+	for (int w = 0; w < flagged.GetWordCount(); w++)
+	{
+		for (uint64_t bits = flagged.GetWord(w); bits != 0u; bits &= bits - 1u)
+		{
+			AddOpeningBlock(w * 64 + BitPlane::PopCount((bits & (0u - bits)) - 1u), 1);
+		}
+		for (uint64_t bits = revealed.GetWord(w); bits != 0u; bits &= bits - 1u)
+		{
+			const int i = w * 64 + BitPlane::PopCount((bits & (0u - bits)) - 1u);
+			if (neighborCounts[i] == 0u)
+			{
+				openingBlockCount[GetOpeningOf(i)]++;
+			}
+		}
+	}
 }
 
-Vei2 MineField::ScreenToGrid(const Vei2 & screenPos)
+void MineField::AddOpeningBlock(int i, int delta)
 {
-	// Convert screen position (pixels) into grid position (tiles)
-	return ((screenPos - topLeft)/SpriteCodex::tileSize);
+	int openings[4];
+	const int nOpenings = GetOpeningsAround({ i % width, i / width }, openings);
+	for (int o = 0; o < nOpenings; o++)
+	{
+		openingBlockCount[openings[o]] += delta;
+	}
 }
 
-int MineField::CountNeighborBombs(const Vei2& gridPos)
+int MineField::GetOpeningsAround(const Vei2& gridPos, int openings[4]) const
 {
-	// Set the boundaries for a gridPos. Maximun 9 tiles covering that gridPos
-	// Taking into account the boundaries of the grid
+	// A zero tile is in its own opening only, any other tile is in the openings of
+	// the zero tiles around it (none for bombs, they never touch a zero tile).
+	// Zero tiles of different openings are never next to each other, so at most
+	// the four corner neighbors can be in different openings
+	const int i = IndexOf(gridPos);
+	if (neighborCounts[i] == 0u)
+	{
+		openings[0] = GetOpeningOf(i);
+		return 1;
+	}
+
+	int n = 0;
 	const int xStart = std::max(0, gridPos.x - 1);
-	const int yStart = std::max(0, gridPos.y - 1);
 	const int xEnd = std::min(width - 1, gridPos.x + 1);
-	const int yEnd = std::min(height - 1, gridPos.y + 1);
-
-	int count = 0;
-	for (Vei2 gridPos = { xStart,yStart }; gridPos.y <= yEnd; gridPos.y++)
+	for (int y = std::max(0, gridPos.y - 1); y <= std::min(height - 1, gridPos.y + 1); y++)
 	{
-		for (gridPos.x = xStart; gridPos.x <= xEnd; gridPos.x++)
+		for (int x = xStart; x <= xEnd; x++)
 		{
-			if (TileAt(gridPos).HasBomb())
+			const int opening = GetOpeningOf(y * width + x);
+			if (opening != -1 && std::find(openings, openings + n, opening) == openings + n)
 			{
-				count++;
+				openings[n++] = opening;
 			}
 		}
 	}
+	return n;
+}
 
-	return count;
+int MineField::GetOpeningOf(int i) const
+{
+	// Rank of the tile among the zero tiles, from the count before its word
+	const uint64_t word = zeroTiles.GetWord(i / 64);
+	const uint64_t bit = uint64_t(1) << (i % 64);
+	if ((word & bit) == 0u)
+	{
+		return -1;
+	}
+	return openingOfZero[zeroRank[i / 64] + BitPlane::PopCount(word & (bit - 1u))];
 }
 
-MineField::State MineField::GetState() const
+int MineField::GetOpeningCount() const
 {
-	return state;
+	if (!openingStart.empty())
+	{
+		return int(openingStart.size()) - 1;
+	}
+
+	// Not labeled, a small field counts them again
+	std::vector<ZeroRun> runs;
+	std::vector<int> openingOfRun;
+	return LabelZeroRuns(neighborCounts.GetData(), width, height, runs, openingOfRun);
 }
 
+int MineField::GetWidth() const
+{
+	return width;
+}
 
-bool MineField::GameIsWon() const
+int MineField::GetHeight() const
+{
+	return height;
+}
+
+int MineField::GetMineCount() const
+{
+	return nMines;
+}
+
+int MineField::GetUnrevealedCount() const
+{
+	// Only valid while no bomb has been revealed, which is all that matters in a running game
+	return nHiddenSafeTiles + nMines;
+}
+
+bool MineField::HasBomb(const Vei2& gridPos) const
+{
+	return mines.Get(IndexOf(gridPos));
+}
+
+bool MineField::IsRevealed(const Vei2& gridPos) const
+{
+	return revealed.Get(IndexOf(gridPos));
+}
+
+bool MineField::IsFlagged(const Vei2& gridPos) const
+{
+	return flagged.Get(IndexOf(gridPos));
+}
+
+const BitPlane& MineField::GetRevealedPlane() const
+{
+	return revealed;
+}
+
+const BitPlane& MineField::GetMinePlane() const
 {
-	// Scan the whole field to check if all of the bombs have been flagged
-	for (const Tile& tile : field)
+	return mines;
+}
+
+const unsigned char* MineField::GetNeighborCounts() const
+{
+	return neighborCounts.GetData();
+}
+
+void MineField::Notify(Event::Type type, const Vei2& gridPos)
+{
+	if (pObserver != nullptr)
 	{
-		if ( (tile.HasBomb() && !tile.IsFlagged()) ||
-			 (!tile.HasBomb() && (!tile.IsRevealed())) )
-		{
-			return false;
-		}
+		pObserver->OnEvent(Event(type, gridPos));
 	}
+}
 
-	return true;
+void MineField::NotifyReveal(int i)
+{
+	// Sent for every tile of an opened area, so skip the position math with no observer
+	if (pObserver != nullptr)
+	{
+		pObserver->OnEvent(Event(Event::Type::Reveal, { i % width, i / width }));
+	}
+}
+
+uint64_t MineField::GetSeed() const
+{
+	return seed;
 }
 
+MineField::State MineField::GetState() const
+{
+	return state;
+}
+
+
+bool MineField::GameIsWon() const
+{
+	// Won when every safe tile is revealed and every bomb is flagged.
+	// Both counters are kept up to date by reveals and flags, so no scan is needed
+	return nHiddenSafeTiles == 0 && nFlaggedMines == nMines;
+}
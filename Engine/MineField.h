@@ -1,9 +1,18 @@
 #pragma once
 
-#include "Graphics.h"
-#include "Sound.h"
+#include "Vei2.h"
+#include "BitPlane.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
 
+class MappedFile;
 
+// Game rules only: mine placement, reveal, flag and game state in grid coordinates.
+// Has no dependency on Graphics or Sound, the presentation side (MineFieldView)
+// follows the field through the events sent to its Observer
 class MineField
 {
 public:
@@ -14,64 +23,259 @@ public:
 		Mineming,
 	};
 
-private:
-	class Tile
+	class Event
 	{
 	public:
-
-		enum class StateTile
+		// Reveal is sent for every safe tile a click uncovers, the tiles of opened areas
+		// and chords included. Lose is sent for the bomb instead
+		enum class Type
 		{
-			Hidden,
-			Flagged,
-			Revealed
-
+			Reveal,
+			Flag,
+			Unflag,
+			Lose,
+			Win
 		};
-		void SpawnBomb();
-		bool HasBomb() const;
-		void Draw(const Vei2 screenPos, MineField::State state, Graphics& gfx) const;
-		void Reveal();
-		bool IsRevealed() const;
-		void ToggleFlag();
-		bool IsFlagged() const;
-		bool HasNoNeighborBombs() const;
-		void SetNeighborBombCount(int bombCount);
-
+	public:
+		Event(Type type, const Vei2& gridPos);
+		Type GetType() const;
+		Vei2 GetPos() const;
 	private:
-		StateTile stateTile = StateTile::Hidden;
-		bool hasBomb = false;		
-		int nNeighborBombs = -1;
+		Type type;
+		Vei2 gridPos;
+	};
+
+	class Observer
+	{
+	public:
+		virtual ~Observer() = default;
+		virtual void OnEvent(const Event& e) = 0;
 	};
 
 public:
-	MineField(const Vei2 center, int nMines);
-	void Draw(Graphics& gfx) const;
-	RectI GetRect() const;
-	void OnRevealClick(const Vei2 screenPos);
-	void OnFlagClick(const Vei2 screenPos);
+	MineField(int nMines);
+	MineField(int width, int height, int nMines);
+	// Fields built from the same seed and parameters are identical
+	MineField(int width, int height, int nMines, uint64_t seed);
+	// No mine on safeStart or its neighbors, so revealing safeStart first opens an area
+	MineField(int width, int height, int nMines, uint64_t seed, const Vei2& safeStart);
+	// Versioned binary snapshot: dimensions, seed, game state, the mine, revealed and
+	// flagged planes and the neighbor counts, in the machine's byte order. False when
+	// the file cannot be written
+	bool Save(const std::string& path) const;
+	// Resumes a game saved with Save(). The file is memory mapped copy-on-write and the
+	// planes and counts are used in place, nothing is rebuilt or copied per tile. The
+	// counts are recounted from the mines a row at a time and must match exactly, and
+	// no tile may be both revealed and flagged, nor a mine revealed in a running game.
+	// Openings are labeled like on a new field and the undo journal starts empty.
+	// nullptr when the file is missing, damaged or of another version
+	static std::unique_ptr<MineField> Load(const std::string& path);
+	// Only one observer at a time, nullptr to stop sending events
+	void SetObserver(Observer* pObserver);
+	void OnRevealClick(const Vei2& gridPos);
+	void OnFlagClick(const Vei2& gridPos);
+	// Reveals every hidden, unflagged neighbor of a revealed number once as many flags
+	// surround it, as one move with a single win check. Does nothing otherwise
+	void OnChordClick(const Vei2& gridPos);
+	// Practice mode: from this call on every click that changed the field is kept in a
+	// journal and can be undone, a lost game included. A new click drops the moves that
+	// were undone. Off by default, bots and tools never undo and journaling every click
+	// costs them about a third of their speed
+	void EnableUndo();
+	// Undo and Redo send no events and do nothing while undo is not enabled
+	bool CanUndo() const;
+	bool CanRedo() const;
+	void Undo();
+	void Redo();
 	State GetState() const;
+	uint64_t GetSeed() const;
+	int GetWidth() const;
+	int GetHeight() const;
+	int GetMineCount() const;
+	// Hidden or flagged tiles, bombs included
+	int GetUnrevealedCount() const;
+	bool IsInside(const Vei2& gridPos) const;
+	bool HasBomb(const Vei2& gridPos) const;
+	bool IsRevealed(const Vei2& gridPos) const;
+	bool IsFlagged(const Vei2& gridPos) const;
+	int GetNeighborBombCount(const Vei2& gridPos) const;
+	// Connected areas of zero tiles, each one is cleared by a single click on a new field.
+	// Free on fields labeled at construction, smaller fields count them on every call
+	int GetOpeningCount() const;
+	// Whole-plane access for code that scans many tiles at once
+	const BitPlane& GetRevealedPlane() const;
+	const BitPlane& GetMinePlane() const;
+	// One count per tile in row order, bomb tiles hold a count of at least 1
+	const unsigned char* GetNeighborCounts() const;
+	// Most mines a field can hold: all tiles but one, or with a safe start all tiles but
+	// the safe start and its neighbors. pSafeStart is nullptr for a field without one
+	static int GetMaxMines(int width, int height, const Vei2* pSafeStart);
+	// Fills counts, one byte per tile in row order, with the number of mines around each
+	// tile like GetNeighborCounts(). This is the pass every field runs at construction
+	static void CountNeighborBombs(const BitPlane& mines, int width, int height, unsigned char* counts);
 
 private:
+	// Zero tiles first to last of one row
+	struct ZeroRun
+	{
+		int first;
+		int last;
+	};
+	// Neighbor counts, one byte per tile. Stored inline up to expert size like the bit
+	// planes, in one heap block shared by all copies above that, or a view over the
+	// counts of a loaded snapshot
+	class NeighborCounts
+	{
+	public:
+		NeighborCounts() = default;
+		// Owned counts of nTiles tiles, to be filled in through GetOwnedData()
+		NeighborCounts(int nTiles);
+		// View over counts owned by someone else, which must outlive it
+		NeighborCounts(const unsigned char* externalCounts);
+		NeighborCounts(const NeighborCounts& src);
+		NeighborCounts& operator=(const NeighborCounts& rhs);
+		unsigned char operator[](int i) const
+		{
+			return counts[i];
+		}
+		const unsigned char* GetData() const
+		{
+			return counts;
+		}
+		// Owned counts only, before the first copy is made
+		unsigned char* GetOwnedData();
+
+	private:
+		static constexpr int nInlineTiles = 512;
+		int nTiles = 0;
+		const unsigned char* counts = nullptr;
+		std::shared_ptr<std::vector<unsigned char>> pHeapCounts;
+		unsigned char inlineCounts[nInlineTiles];
+	};
+
+private:
+	MineField(int width, int height, int nMines, uint64_t seed, const Vei2* pSafeStart);
+	// Plays on from the planes of a mapped snapshot, with the running counts Load() took
+	MineField(std::shared_ptr<MappedFile> pSnapshot, int width, int height, int nMines, uint64_t seed, State state,
+		int nRevealedSafeTiles, int nFlaggedMines);
+	// True when the neighbor counts of a snapshot are exactly the ones of its mines
+	static bool CountsMatchMines(const BitPlane& minePlane, int width, int height, const unsigned char* counts);
+	void PlaceMines(uint64_t seed, const Vei2* pSafeStart);
 	void RevealTile(const Vei2& gridPos);
-	Tile& TileAt(const Vei2& gridPos);
-	const Tile& TileAt(const Vei2& gridPos) const;
-	Vei2 ScreenToGrid(const Vei2& screenPos);
-	int CountNeighborBombs(const Vei2& gridPos);
+	void ToggleFlag(int i);
+	void RecordMove(int tile, bool isFlag);
+	// Frees worklists a big reveal left large
+	void TrimWorklists();
+	// Reveals or hides again the tiles uncovered by journal move m
+	void SetMoveRevealed(size_t m, bool isRevealed);
+	int IndexOf(const Vei2& gridPos) const;
+	// Horizontal 3-tile sums of mine row y, the first step of counting neighbors
+	static void SumMineRow(const BitPlane& mines, int width, int height, int y, unsigned char* paddedRow,
+		unsigned char* out);
+	static void CountNeighborBombRows(const BitPlane& mines, int width, int height, int yStart, int yEnd,
+		unsigned char* counts);
+	static void CountNeighborBombsParallel(const BitPlane& mines, int width, int height, unsigned char* counts);
+	// Runs of zero tiles in tile order and the opening of each, numbered by their first
+	// tile. One pass over the tiles, returns the number of openings
+	static int LabelZeroRuns(const unsigned char* counts, int width, int height, std::vector<ZeroRun>& runs,
+		std::vector<int>& openingOfRun);
+	void LabelOpenings();
+	int GetOpeningsAround(const Vei2& gridPos, int openings[4]) const;
+	// Opening of zero tile i, -1 for any other tile
+	int GetOpeningOf(int i) const;
+	// Adds delta to the block count of every opening tile i is in
+	void AddOpeningBlock(int i, int delta);
+	// Reveals the opening of zero tile i, which was just revealed, in one sweep when
+	// nothing else in it is revealed or flagged. Queues i for FloodFill() otherwise
+	void RevealOpening(int i);
+	// Floods from every zero tile in revealQueue in one pass
+	void FloodFill();
 	bool GameIsWon() const;
-	
+	void Notify(Event::Type type, const Vei2& gridPos);
+	void NotifyReveal(int i);
 
 private:
 
-	static constexpr int width = 8;
-	static constexpr int height = 6;
-	static constexpr int borderThickness = 10;
-	static constexpr Color borderColor = Colors::Blue;
-	Sound sndLose = Sound(L"spayed.wav");
+	// Field size used when no size is given
+	static constexpr int defaultWidth = 8;
+	static constexpr int defaultHeight = 6;
+	// Fields with at least this many tiles count neighbors on all cores
+	static constexpr int parallelThreshold = 1 << 20;
+	// Fields with at least this many tiles label their openings at construction and reveal
+	// zero tiles by sweeping them. Smaller fields, like the ones bots play, always flood
+	// fill, labeling them costs more than it saves
+	static constexpr int openingThreshold = 1 << 16;
+	// Rows up to this width are counted in buffers on the stack
+	static constexpr int maxStackRowWidth = 512;
+	// Worklists with a bigger capacity are freed after each move instead of reused
+	static constexpr size_t maxKeptWorklist = 1 << 12;
 
-	Vei2 topLeft;
+	int width;
+	int height;
 
 	State state = State::Mineming;
-	
+	int nMines;
+	uint64_t seed;
+
+	// Running counts for the win check
+	int nHiddenSafeTiles;
+	int nFlaggedMines = 0;
+
+	// Tile state is kept in bit planes instead of an array of tiles. Planes for
+	// fields up to expert size are stored inline, bigger fields go to the heap
+	BitPlane mines;
+	BitPlane revealed;
+	BitPlane flagged;
+
+	// Number of bombs around each tile in row order, filled in once at construction or
+	// read straight from a loaded snapshot. Never changes, so copies of a field bigger
+	// than expert size share it
+	NeighborCounts neighborCounts;
+
+	// Openings: each connected area of zero tiles plus its numbered border, labeled at
+	// construction of a big field and kept as the runs of its zero tiles, so revealing a
+	// zero tile is one sweep over the rows around them. Empty on small fields
+	std::vector<int> openingStart;
+	std::vector<ZeroRun> openingRuns;
+	// Flags and revealed zero tiles in each opening. The sweep only matches a flood fill
+	// while this is 0: flags stop the fill and revealed ground can cut tiles off from the
+	// clicked one, so those openings fall back to FloodFill()
+	std::vector<int> openingBlockCount;
+	// Opening of each zero tile in tile order, found through the plane of zero tiles and
+	// the number of zero tiles before each of its words. With 10% mines about 40% of the
+	// tiles are zero tiles, so this is far smaller than an opening per tile
+	BitPlane zeroTiles;
+	std::vector<int> zeroRank;
+	std::vector<int> openingOfZero;
+
+	// Worklist reused by every flood fill reveal
+	std::vector<int> revealQueue;
+
+	// Undo journal, one record per click that changed the field. Moves always start
+	// from a running game, so only the state after the move is stored. Empty and never
+	// written while undo is not enabled
+	bool isUndoEnabled = false;
+	struct Move
+	{
+		int tile;
+		bool isFlag;
+		State stateAfter;
+		int nSafeRevealed;
+		// Offset of the move's runs in journalRuns, they end where the next move's begin
+		size_t runsStart;
+	};
+	std::vector<Move> journal;
+	// Tiles uncovered by each reveal as runs of consecutive indices, stored as varint
+	// pairs (gap since the end of the previous run, run length). A flood fill costs a
+	// few bytes per row it crosses instead of a copy of the board
+	std::vector<unsigned char> journalRuns;
+	// Moves in the journal that are currently applied, the rest can be redone
+	size_t nApplied = 0;
+	// Tiles revealed by the click in progress, only collected while undo is enabled
+	std::vector<int> moveTiles;
+
+	// Snapshot whose pages back the planes of a loaded field, nullptr otherwise
+	std::shared_ptr<MappedFile> pSnapshot;
 
-	// Tiles in the field
-	Tile field[width * height];
+	Observer* pObserver = nullptr;
 };
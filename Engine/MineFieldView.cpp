@@ -0,0 +1,114 @@
+#include "MineFieldView.h"
+#include "SpriteCodex.h"
+
+MineFieldView::MineFieldView(MineField& field, const Vei2 center)
+	:field(field),
+	topLeft(center - Vei2(field.GetWidth() * SpriteCodex::tileSize, field.GetHeight() * SpriteCodex::tileSize) / 2)
+{
+	field.SetObserver(this);
+}
+
+MineFieldView::~MineFieldView()
+{
+	field.SetObserver(nullptr);
+}
+
+SpriteCodex::TileVariant MineFieldView::GetTileVariant(const Vei2& gridPos) const
+{
+	const bool hasBomb = field.HasBomb(gridPos);
+
+	if (field.IsRevealed(gridPos))
+	{
+		if (!hasBomb)
+		{
+			return SpriteCodex::TileVariant(field.GetNeighborBombCount(gridPos));
+		}
+		return field.GetState() != MineField::State::Fucked ? SpriteCodex::TileVariant::Bomb : SpriteCodex::TileVariant::BombRed;
+	}
+
+	if (field.GetState() != MineField::State::Fucked)
+	{
+		return field.IsFlagged(gridPos) ? SpriteCodex::TileVariant::Flagged : SpriteCodex::TileVariant::Button;
+	}
+	else // We are fucked
+	{
+		if (field.IsFlagged(gridPos))
+		{
+			return hasBomb ? SpriteCodex::TileVariant::BombFlagged : SpriteCodex::TileVariant::BombCrossed;
+		}
+		return hasBomb ? SpriteCodex::TileVariant::Bomb : SpriteCodex::TileVariant::Button;
+	}
+}
+
+void MineFieldView::Draw(Graphics& gfx) const
+{
+	gfx.DrawRect(GetRect().GetExpanded(borderThickness), borderColor);
+
+	// Cached tiles are opaque and already hold the base color, so the field
+	// needs no background fill
+	for (Vei2 gridPos = {0,0 }; gridPos.y < field.GetHeight(); gridPos.y++)
+	{
+		for (gridPos.x = 0; gridPos.x < field.GetWidth(); gridPos.x++)
+		{
+			SpriteCodex::DrawTile(GetTileVariant(gridPos), topLeft + gridPos * SpriteCodex::tileSize, gfx);
+		}
+	}
+}
+
+RectI MineFieldView::GetRect() const
+{
+	return RectI(topLeft, field.GetWidth() * SpriteCodex::tileSize, field.GetHeight() * SpriteCodex::tileSize);
+}
+
+void MineFieldView::OnRevealClick(const Vei2 screenPos)
+{
+	const Vei2 gridPos = ScreenToGrid(screenPos);
+
+	// Clicking a number that is already showing chords it
+	if (field.IsRevealed(gridPos))
+	{
+		Record(gridPos, Replay::Action::Chord);
+		field.OnChordClick(gridPos);
+	}
+	else
+	{
+		Record(gridPos, Replay::Action::Reveal);
+		field.OnRevealClick(gridPos);
+	}
+}
+
+void MineFieldView::OnFlagClick(const Vei2 screenPos)
+{
+	const Vei2 gridPos = ScreenToGrid(screenPos);
+	Record(gridPos, Replay::Action::Flag);
+	field.OnFlagClick(gridPos);
+}
+
+void MineFieldView::SetReplay(Replay* pReplay_in)
+{
+	pReplay = pReplay_in;
+	replayStart = std::chrono::steady_clock::now();
+}
+
+void MineFieldView::Record(const Vei2& gridPos, Replay::Action action)
+{
+	if (pReplay != nullptr)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - replayStart;
+		pReplay->AddClick(gridPos, action, uint32_t(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+	}
+}
+
+void MineFieldView::OnEvent(const MineField::Event& e)
+{
+	if (e.GetType() == MineField::Event::Type::Lose)
+	{
+		sndLose.Play();
+	}
+}
+
+Vei2 MineFieldView::ScreenToGrid(const Vei2& screenPos) const
+{
+	// Convert screen position (pixels) into grid position (tiles)
+	return ((screenPos - topLeft) / SpriteCodex::tileSize);
+}
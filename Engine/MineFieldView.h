@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Graphics.h"
+#include "Sound.h"
+#include "MineField.h"
+#include "Replay.h"
+#include "SpriteCodex.h"
+#include <chrono>
+
+// Draws a MineField on screen, turns screen clicks into grid clicks
+// and plays the sounds for the events the field sends
+class MineFieldView : public MineField::Observer
+{
+public:
+	MineFieldView(MineField& field, const Vei2 center);
+	MineFieldView(const MineFieldView&) = delete;
+	MineFieldView& operator=(const MineFieldView&) = delete;
+	~MineFieldView();
+	void Draw(Graphics& gfx) const;
+	RectI GetRect() const;
+	void OnRevealClick(const Vei2 screenPos);
+	void OnFlagClick(const Vei2 screenPos);
+	// Clicks are added to pReplay, timed from this call. nullptr stops recording
+	void SetReplay(Replay* pReplay);
+	void OnEvent(const MineField::Event& e) override;
+
+private:
+	SpriteCodex::TileVariant GetTileVariant(const Vei2& gridPos) const;
+	Vei2 ScreenToGrid(const Vei2& screenPos) const;
+	void Record(const Vei2& gridPos, Replay::Action action);
+
+private:
+	static constexpr int borderThickness = 10;
+	static constexpr Color borderColor = Colors::Blue;
+	Sound sndLose = Sound(L"spayed.wav");
+
+	MineField& field;
+	Vei2 topLeft;
+
+	Replay* pReplay = nullptr;
+	std::chrono::steady_clock::time_point replayStart;
+};
@@ -0,0 +1,99 @@
+#include "NoGuessGenerator.h"
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+NoGuessGenerator::NoGuessGenerator(int width, int height, int nMines, const Vei2& firstClick)
+	:width(width),
+	height(height),
+	nMines(nMines),
+	firstClick(firstClick)
+{
+	assert(firstClick.x >= 0 && firstClick.x < width && firstClick.y >= 0 && firstClick.y < height);
+}
+
+std::vector<uint64_t> NoGuessGenerator::Generate(uint64_t seed, int count, long long maxCandidates, int nThreads)
+{
+	if (nThreads <= 0)
+	{
+		nThreads = std::max(1, int(std::thread::hardware_concurrency()));
+	}
+
+	// Workers take candidate numbers in increasing order and stop at the count-th
+	// passing one found so far, or at maxCandidates. That cutoff only moves down, so
+	// every candidate below the final cutoff has been checked and the result does not
+	// depend on timing
+	std::atomic<long long> next(0);
+	std::atomic<long long> checked(0);
+	std::atomic<long long> cutoff(count > 0 ? std::max(0LL, maxCandidates) : 0);
+	std::mutex passedMutex;
+	std::vector<long long> passed;
+
+	auto work = [&]()
+	{
+		Solver solver;
+		for (long long i = next++; i < cutoff.load(); i = next++)
+		{
+			checked++;
+			if (IsNoGuess(seed + uint64_t(i), solver))
+			{
+				std::lock_guard<std::mutex> lock(passedMutex);
+				passed.insert(std::upper_bound(passed.begin(), passed.end(), i), i);
+				if (int(passed.size()) >= count)
+				{
+					cutoff = std::min(cutoff.load(), passed[count - 1]);
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(nThreads);
+	for (int t = 0; t < nThreads; t++)
+	{
+		workers.emplace_back(work);
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	nCandidates = checked;
+	std::vector<uint64_t> seeds;
+	for (int n = 0; n < std::min(count, int(passed.size())); n++)
+	{
+		seeds.push_back(seed + uint64_t(passed[n]));
+	}
+	return seeds;
+}
+
+long long NoGuessGenerator::GetCandidateCount() const
+{
+	return nCandidates;
+}
+
+bool NoGuessGenerator::IsNoGuess(uint64_t seed, Solver& solver) const
+{
+	MineField field(width, height, nMines, seed, firstClick);
+	field.OnRevealClick(firstClick);
+	solver.Reset(field);
+
+	// Reveal everything the solver proves until the field is cleared or nothing is left to prove
+	size_t nPlayed = 0;
+	while (field.GetUnrevealedCount() > nMines)
+	{
+		solver.Update(field);
+		const std::vector<int>& safeTiles = solver.GetSafeTiles();
+		if (nPlayed == safeTiles.size())
+		{
+			return false;
+		}
+		for (; nPlayed < safeTiles.size(); nPlayed++)
+		{
+			field.OnRevealClick({ safeTiles[nPlayed] % width, safeTiles[nPlayed] / width });
+		}
+	}
+	return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "MineField.h"
+#include "Solver.h"
+#include <vector>
+#include <stdint.h>
+
+// Finds MineField seeds that can be won from the first click without guessing.
+// A candidate field passes when the Solver, starting from the area opened by
+// firstClick, proves every safe tile. The found seeds are rebuilt with
+// MineField(width, height, nMines, seed, firstClick)
+class NoGuessGenerator
+{
+public:
+	NoGuessGenerator(int width, int height, int nMines, const Vei2& firstClick);
+	// Seeds of the first count candidates among seed, seed + 1, ... that pass, in order.
+	// At most maxCandidates candidates are checked, so fewer seeds come back when too
+	// few boards pass, none if no board can. Candidates are checked on nThreads worker
+	// threads (0 for one per core) and the result is the same for any thread count
+	std::vector<uint64_t> Generate(uint64_t seed, int count, long long maxCandidates, int nThreads = 0);
+	// Candidates checked by the last Generate(), passed or not
+	long long GetCandidateCount() const;
+	bool IsNoGuess(uint64_t seed, Solver& solver) const;
+
+private:
+	int width;
+	int height;
+	int nMines;
+	Vei2 firstClick;
+	long long nCandidates = 0;
+};
@@ -0,0 +1,447 @@
+#include "ProbabilityEngine.h"
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+// Ways to choose k mines among the n tiles of a group (a group has at most 8 tiles)
+static const double choose[9][9] = {
+	{  1,  0,  0,  0,  0,  0,  0,  0,  0 },
+	{  1,  1,  0,  0,  0,  0,  0,  0,  0 },
+	{  1,  2,  1,  0,  0,  0,  0,  0,  0 },
+	{  1,  3,  3,  1,  0,  0,  0,  0,  0 },
+	{  1,  4,  6,  4,  1,  0,  0,  0,  0 },
+	{  1,  5, 10, 10,  5,  1,  0,  0,  0 },
+	{  1,  6, 15, 20, 15,  6,  1,  0,  0 },
+	{  1,  7, 21, 35, 35, 21,  7,  1,  0 },
+	{  1,  8, 28, 56, 70, 56, 28,  8,  1 } };
+
+bool ProbabilityEngine::Compute(const MineField& field, long long maxNodes)
+{
+	width = field.GetWidth();
+	height = field.GetHeight();
+	nodeBudget = maxNodes;
+
+	BuildFrontier(field);
+	BuildGroups();
+	SplitComponents();
+
+	const int nComponents = int(componentStart.size()) - 1;
+	weightStart.resize(nComponents + 1);
+	hitStart.resize(nComponents + 1);
+	weightStart[0] = 0;
+	hitStart[0] = 0;
+	for (int c = 0; c < nComponents; c++)
+	{
+		int nTiles = 0;
+		for (int i = componentStart[c]; i < componentStart[c + 1]; i++)
+		{
+			const int g = componentGroups[i];
+			nTiles += groupVarStart[g + 1] - groupVarStart[g];
+		}
+		weightStart[c + 1] = weightStart[c] + nTiles + 1;
+		hitStart[c + 1] = hitStart[c] + (componentStart[c + 1] - componentStart[c]) * (nTiles + 1);
+	}
+	weights.assign(weightStart[nComponents], 0.0);
+	hits.assign(hitStart[nComponents], 0.0);
+
+	for (int c = 0; c < nComponents; c++)
+	{
+		if (!EnumerateComponent(c))
+		{
+			return false;
+		}
+	}
+
+	Combine(field);
+	return true;
+}
+
+float ProbabilityEngine::GetMineProbability(const Vei2& gridPos) const
+{
+	// Revealed tiles are stored as -1 so GetSafestTile() can skip them
+	return std::max(0.0f, probabilities[gridPos.y * width + gridPos.x]);
+}
+
+float ProbabilityEngine::GetInteriorProbability() const
+{
+	return interiorProbability;
+}
+
+Vei2 ProbabilityEngine::GetSafestTile() const
+{
+	Vei2 safest = { -1,-1 };
+	float lowest = 2.0f;
+	for (int i = 0; i < width * height; i++)
+	{
+		if (probabilities[i] >= 0.0f && probabilities[i] < lowest)
+		{
+			lowest = probabilities[i];
+			safest = { i % width, i / width };
+		}
+	}
+	return safest;
+}
+
+void ProbabilityEngine::BuildFrontier(const MineField& field)
+{
+	const int nTiles = width * height;
+	varOfTile.assign(nTiles, -1);
+	tileOfVar.clear();
+	constraints.clear();
+
+	// Every revealed number with hidden neighbors constrains those neighbors
+	for (Vei2 gridPos = { 0,0 }; gridPos.y < height; gridPos.y++)
+	{
+		for (gridPos.x = 0; gridPos.x < width; gridPos.x++)
+		{
+			if (!field.IsRevealed(gridPos))
+			{
+				continue;
+			}
+
+			Constraint c;
+			c.nMines = field.GetNeighborBombCount(gridPos);
+
+			const int xEnd = std::min(width - 1, gridPos.x + 1);
+			const int yEnd = std::min(height - 1, gridPos.y + 1);
+			for (Vei2 n = { 0, std::max(0, gridPos.y - 1) }; n.y <= yEnd; n.y++)
+			{
+				for (n.x = std::max(0, gridPos.x - 1); n.x <= xEnd; n.x++)
+				{
+					if (!field.IsRevealed(n))
+					{
+						const int t = n.y * width + n.x;
+						if (varOfTile[t] == -1)
+						{
+							varOfTile[t] = int(tileOfVar.size());
+							tileOfVar.push_back(t);
+						}
+						c.vars[c.nVars++] = varOfTile[t];
+					}
+				}
+			}
+
+			if (c.nVars > 0)
+			{
+				c.nOpen = c.nVars;
+				constraints.push_back(c);
+			}
+		}
+	}
+
+	const int nVars = int(tileOfVar.size());
+	nInterior = nTiles - field.GetRevealedPlane().Count() - nVars;
+
+	// Constraint lists per variable, each sorted since constraints are visited in order
+	varConstraintStart.assign(nVars + 1, 0);
+	for (const Constraint& c : constraints)
+	{
+		for (int v = 0; v < c.nVars; v++)
+		{
+			varConstraintStart[c.vars[v] + 1]++;
+		}
+	}
+	for (int v = 0; v < nVars; v++)
+	{
+		varConstraintStart[v + 1] += varConstraintStart[v];
+	}
+	varConstraints.resize(varConstraintStart[nVars]);
+	fillCursor.assign(varConstraintStart.begin(), varConstraintStart.end() - 1);
+	for (int c = 0; c < int(constraints.size()); c++)
+	{
+		for (int v = 0; v < constraints[c].nVars; v++)
+		{
+			varConstraints[fillCursor[constraints[c].vars[v]]++] = c;
+		}
+	}
+}
+
+void ProbabilityEngine::BuildGroups()
+{
+	// Sort variables by their constraint lists so equal lists end up next to each other
+	const int nVars = int(tileOfVar.size());
+	groupVars.resize(nVars);
+	for (int v = 0; v < nVars; v++)
+	{
+		groupVars[v] = v;
+	}
+	std::sort(groupVars.begin(), groupVars.end(), [this](int a, int b)
+	{
+		return std::lexicographical_compare(
+			varConstraints.begin() + varConstraintStart[a], varConstraints.begin() + varConstraintStart[a + 1],
+			varConstraints.begin() + varConstraintStart[b], varConstraints.begin() + varConstraintStart[b + 1]);
+	});
+
+	groupOfVar.resize(nVars);
+	groupVarStart.clear();
+	for (int i = 0; i < nVars; i++)
+	{
+		const int v = groupVars[i];
+		const int prev = i > 0 ? groupVars[i - 1] : -1;
+		if (prev == -1 ||
+			varConstraintStart[v + 1] - varConstraintStart[v] != varConstraintStart[prev + 1] - varConstraintStart[prev] ||
+			!std::equal(varConstraints.begin() + varConstraintStart[v], varConstraints.begin() + varConstraintStart[v + 1],
+				varConstraints.begin() + varConstraintStart[prev]))
+		{
+			groupVarStart.push_back(i);
+		}
+		groupOfVar[v] = int(groupVarStart.size()) - 1;
+	}
+	groupVarStart.push_back(nVars);
+}
+
+void ProbabilityEngine::SplitComponents()
+{
+	// Breadth-first walk over groups sharing a number. Each walk is one component,
+	// and the walk order keeps constraints closing early during backtracking
+	const int nGroups = int(groupVarStart.size()) - 1;
+	componentOfGroup.assign(nGroups, -1);
+	componentGroups.clear();
+	componentStart.assign(1, 0);
+
+	for (int seedGroup = 0; seedGroup < nGroups; seedGroup++)
+	{
+		if (componentOfGroup[seedGroup] != -1)
+		{
+			continue;
+		}
+
+		const int component = int(componentStart.size()) - 1;
+		componentOfGroup[seedGroup] = component;
+		componentGroups.push_back(seedGroup);
+
+		for (size_t head = componentStart.back(); head < componentGroups.size(); head++)
+		{
+			// All variables of a group share their constraints, the first one stands for all
+			const int v = groupVars[groupVarStart[componentGroups[head]]];
+			for (int k = varConstraintStart[v]; k < varConstraintStart[v + 1]; k++)
+			{
+				const Constraint& c = constraints[varConstraints[k]];
+				for (int u = 0; u < c.nVars; u++)
+				{
+					const int g = groupOfVar[c.vars[u]];
+					if (componentOfGroup[g] == -1)
+					{
+						componentOfGroup[g] = component;
+						componentGroups.push_back(g);
+					}
+				}
+			}
+		}
+
+		componentStart.push_back(int(componentGroups.size()));
+	}
+}
+
+bool ProbabilityEngine::EnumerateComponent(int component)
+{
+	orderBegin = componentGroups.data() + componentStart[component];
+	orderSize = componentStart[component + 1] - componentStart[component];
+	orderTiles = weightStart[component + 1] - weightStart[component] - 1;
+	componentBase = component;
+	assignment.assign(orderSize, 0u);
+
+	if (!Backtrack(0, 0, 1.0))
+	{
+		return false;
+	}
+
+	// Only ratios matter, scale so the largest weight is 1 to keep the products in range
+	double* w = &weights[weightStart[component]];
+	const double largest = *std::max_element(w, w + orderTiles + 1);
+	if (largest > 0.0)
+	{
+		const double scale = 1.0 / largest;
+		std::for_each(w, w + orderTiles + 1, [scale](double& x) { x *= scale; });
+		std::for_each(hits.begin() + hitStart[component], hits.begin() + hitStart[component + 1],
+			[scale](double& x) { x *= scale; });
+	}
+	return true;
+}
+
+bool ProbabilityEngine::Backtrack(int depth, int nPlaced, double weight)
+{
+	if (--nodeBudget < 0)
+	{
+		return false;
+	}
+
+	if (depth == orderSize)
+	{
+		// weight more layouts with nPlaced mines
+		weights[weightStart[componentBase] + nPlaced] += weight;
+		double* h = &hits[hitStart[componentBase]];
+		for (int local = 0; local < orderSize; local++)
+		{
+			if (assignment[local])
+			{
+				h[local * (orderTiles + 1) + nPlaced] += weight * assignment[local];
+			}
+		}
+		return true;
+	}
+
+	// Range of mine counts in this group that every number around it still allows
+	const int group = orderBegin[depth];
+	const int size = groupVarStart[group + 1] - groupVarStart[group];
+	const int v = groupVars[groupVarStart[group]];
+	int lowest = 0;
+	int highest = size;
+	for (int k = varConstraintStart[v]; k < varConstraintStart[v + 1]; k++)
+	{
+		const Constraint& c = constraints[varConstraints[k]];
+		highest = std::min(highest, c.nMines - c.nPlaced);
+		lowest = std::max(lowest, c.nMines - c.nPlaced - (c.nOpen - size));
+	}
+
+	for (int n = lowest; n <= highest; n++)
+	{
+		Assign(group, n);
+		assignment[depth] = (unsigned char)n;
+		if (!Backtrack(depth + 1, nPlaced + n, weight * choose[size][n]))
+		{
+			return false;
+		}
+		Unassign(group, n);
+	}
+	assignment[depth] = 0u;
+	return true;
+}
+
+void ProbabilityEngine::Assign(int group, int nMines)
+{
+	const int size = groupVarStart[group + 1] - groupVarStart[group];
+	const int v = groupVars[groupVarStart[group]];
+	for (int k = varConstraintStart[v]; k < varConstraintStart[v + 1]; k++)
+	{
+		Constraint& c = constraints[varConstraints[k]];
+		c.nOpen -= size;
+		c.nPlaced += nMines;
+	}
+}
+
+void ProbabilityEngine::Unassign(int group, int nMines)
+{
+	const int size = groupVarStart[group + 1] - groupVarStart[group];
+	const int v = groupVars[groupVarStart[group]];
+	for (int k = varConstraintStart[v]; k < varConstraintStart[v + 1]; k++)
+	{
+		Constraint& c = constraints[varConstraints[k]];
+		c.nOpen += size;
+		c.nPlaced -= nMines;
+	}
+}
+
+void ProbabilityEngine::Combine(const MineField& field)
+{
+	const int nMines = field.GetMineCount();
+	const int nComponents = int(componentStart.size()) - 1;
+
+	while (int(logFactorials.size()) <= nInterior)
+	{
+		logFactorials.push_back(logFactorials.empty() ? 0.0 :
+			logFactorials.back() + std::log(double(logFactorials.size())));
+	}
+
+	// Weight of putting r mines on the interior tiles: C(nInterior, r), relative to the largest
+	binomialWeights.assign(nMines + 1, 0.0);
+	double largestLog = -1e300;
+	for (int r = 0; r <= std::min(nMines, nInterior); r++)
+	{
+		const double logC = logFactorials[nInterior] - logFactorials[r] - logFactorials[nInterior - r];
+		binomialWeights[r] = logC;
+		largestLog = std::max(largestLog, logC);
+	}
+	for (int r = 0; r <= nMines; r++)
+	{
+		binomialWeights[r] = r <= nInterior ? std::exp(binomialWeights[r] - largestLog) : 0.0;
+	}
+	auto interiorWeight = [this, nMines](int frontierMines)
+	{
+		const int r = nMines - frontierMines;
+		return r >= 0 ? binomialWeights[r] : 0.0;
+	};
+
+	// Convolves the mine count distributions of all components except skip
+	auto convolve = [this, nComponents](int skip, std::vector<double>& out)
+	{
+		out.assign(1, 1.0);
+		for (int c = 0; c < nComponents; c++)
+		{
+			if (c == skip)
+			{
+				continue;
+			}
+			const int nTiles = weightStart[c + 1] - weightStart[c] - 1;
+			const double* w = &weights[weightStart[c]];
+			scratch.assign(out.size() + nTiles, 0.0);
+			for (size_t m = 0; m < out.size(); m++)
+			{
+				if (out[m] != 0.0)
+				{
+					for (int k = 0; k <= nTiles; k++)
+					{
+						scratch[m + k] += out[m] * w[k];
+					}
+				}
+			}
+			out.swap(scratch);
+		}
+	};
+
+	convolve(-1, total);
+	double totalWeight = 0.0;
+	double interiorMines = 0.0;
+	for (size_t m = 0; m < total.size(); m++)
+	{
+		const double weight = total[m] * interiorWeight(int(m));
+		totalWeight += weight;
+		interiorMines += weight * double(nMines - int(m));
+	}
+	assert(totalWeight > 0.0);
+
+	probabilities.assign(width * height, -1.0f);
+	interiorProbability = nInterior > 0 ? float(interiorMines / (totalWeight * nInterior)) : 0.0f;
+
+	for (int i = 0; i < width * height; i++)
+	{
+		if (varOfTile[i] == -1 && !field.IsRevealed({ i % width, i / width }))
+		{
+			probabilities[i] = interiorProbability;
+		}
+	}
+
+	for (int c = 0; c < nComponents; c++)
+	{
+		// Weight of this component holding k mines, with every other part of the board summed out
+		convolve(c, others);
+		const int nTiles = weightStart[c + 1] - weightStart[c] - 1;
+		scratch.assign(nTiles + 1, 0.0);
+		for (int k = 0; k <= nTiles; k++)
+		{
+			for (size_t m = 0; m < others.size(); m++)
+			{
+				scratch[k] += others[m] * interiorWeight(k + int(m));
+			}
+		}
+
+		const double* h = &hits[hitStart[c]];
+		for (int local = 0; local < componentStart[c + 1] - componentStart[c]; local++)
+		{
+			double groupMines = 0.0;
+			for (int k = 0; k <= nTiles; k++)
+			{
+				groupMines += h[local * (nTiles + 1) + k] * scratch[k];
+			}
+
+			// Tiles of a group are interchangeable, so they share the group's mines evenly
+			const int group = componentGroups[componentStart[c] + local];
+			const int size = groupVarStart[group + 1] - groupVarStart[group];
+			const float p = float(groupMines / (totalWeight * size));
+			for (int i = groupVarStart[group]; i < groupVarStart[group + 1]; i++)
+			{
+				probabilities[tileOfVar[groupVars[i]]] = p;
+			}
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "MineField.h"
+#include <vector>
+
+// Exact mine probability of every hidden tile, given the numbers revealed on a MineField
+// and its total mine count.
+// Hidden tiles next to a number (the frontier) are grouped by the numbers they touch,
+// the groups are split into independent components, each component's mine layouts are
+// counted by backtracking, and the components are combined with the tiles away from the
+// frontier using binomial weights for how many mines those hold. Flags are treated as
+// hidden tiles.
+// Working buffers are kept between calls, so calling Compute() every move is cheap
+class ProbabilityEngine
+{
+public:
+	// Returns false when the enumeration needed more than maxNodes backtracking steps,
+	// the probabilities are not valid then
+	bool Compute(const MineField& field, long long maxNodes = 200000);
+	// Probability that the tile hides a mine, 0 for revealed tiles
+	float GetMineProbability(const Vei2& gridPos) const;
+	// Probability for any hidden tile that touches no revealed number
+	float GetInteriorProbability() const;
+	// Hidden tile with the lowest mine probability, (-1,-1) when no tile is hidden
+	Vei2 GetSafestTile() const;
+
+private:
+	class Constraint
+	{
+	public:
+		int nVars = 0;
+		int vars[8];
+		int nMines = 0;
+		// Backtracking state: mines placed and tiles still open
+		int nPlaced = 0;
+		int nOpen = 0;
+	};
+
+private:
+	void BuildFrontier(const MineField& field);
+	void BuildGroups();
+	void SplitComponents();
+	bool EnumerateComponent(int component);
+	bool Backtrack(int depth, int nPlaced, double weight);
+	void Assign(int group, int nMines);
+	void Unassign(int group, int nMines);
+	void Combine(const MineField& field);
+
+private:
+	int width = 0;
+	int height = 0;
+	long long nodeBudget = 0;
+
+	// Frontier variables (hidden tiles next to a number) and the numbers constraining them
+	std::vector<int> varOfTile;
+	std::vector<int> tileOfVar;
+	std::vector<Constraint> constraints;
+	// Constraints of every variable, in CSR layout
+	std::vector<int> varConstraintStart;
+	std::vector<int> varConstraints;
+	std::vector<int> fillCursor;
+	int nInterior = 0;
+
+	// Groups: variables touching exactly the same numbers are interchangeable, so only
+	// the number of mines in each group is enumerated
+	std::vector<int> groupOfVar;
+	std::vector<int> groupVarStart;
+	std::vector<int> groupVars;
+
+	// Components: groups linked by a shared number, in backtracking order
+	std::vector<int> componentStart;
+	std::vector<int> componentGroups;
+	std::vector<int> componentOfGroup;
+
+	// Per component c and mine count k: weight of the layouts (weights), and per group
+	// the number of mines in it summed over those layouts (hits)
+	std::vector<int> weightStart;
+	std::vector<double> weights;
+	std::vector<int> hitStart;
+	std::vector<double> hits;
+
+	// Backtracking state of the component being enumerated
+	const int* orderBegin = nullptr;
+	int orderSize = 0;
+	int orderTiles = 0;
+	int componentBase = 0;
+	std::vector<unsigned char> assignment;
+
+	// Scratch for combining the components
+	std::vector<double> binomialWeights;
+	// log(n!) for n up to the most interior tiles seen so far. std::lgamma would write the
+	// global signgam, which races when engines run on several threads
+	std::vector<double> logFactorials;
+	std::vector<double> total;
+	std::vector<double> others;
+	std::vector<double> scratch;
+
+	std::vector<float> probabilities;
+	float interiorProbability = 0.0f;
+};
@@ -0,0 +1,219 @@
+#include "Replay.h"
+#include "MineField.h"
+#include "Varint.h"
+#include <assert.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const char replayMagic[4] = { 'M','R','P','L' };
+// Bump when the stream layout changes, older replays then fail Verify()
+static constexpr unsigned char replayVersion = 2u;
+
+Replay::Replay(int width, int height, int nMines, uint64_t seed)
+{
+	WriteHeader(width, height, nMines, seed, nullptr);
+}
+
+Replay::Replay(int width, int height, int nMines, uint64_t seed, const Vei2& safeStart)
+{
+	WriteHeader(width, height, nMines, seed, &safeStart);
+}
+
+Replay::Replay(std::vector<unsigned char> bytes)
+	:bytes(std::move(bytes))
+{
+}
+
+void Replay::WriteHeader(int width_in, int height, int nMines, uint64_t seed, const Vei2* pSafeStart)
+{
+	width = width_in;
+	bytes.assign(replayMagic, replayMagic + sizeof(replayMagic));
+	bytes.push_back(replayVersion);
+	WriteVarint(bytes, uint64_t(width));
+	WriteVarint(bytes, uint64_t(height));
+	WriteVarint(bytes, uint64_t(nMines));
+	WriteVarint(bytes, seed);
+	bytes.push_back(pSafeStart != nullptr ? 1u : 0u);
+	if (pSafeStart != nullptr)
+	{
+		WriteVarint(bytes, uint64_t(pSafeStart->x));
+		WriteVarint(bytes, uint64_t(pSafeStart->y));
+	}
+}
+
+void Replay::AddClick(const Vei2& gridPos, Action action, uint32_t timeMs)
+{
+	// Only replays recorded here can grow, received ones are read only
+	assert(width > 0);
+	assert(timeMs >= lastTimeMs);
+	assert(gridPos.x >= 0 && gridPos.x < width && gridPos.y >= 0);
+
+	WriteVarint(bytes, timeMs - lastTimeMs);
+	WriteVarint(bytes, (uint64_t(gridPos.y) * uint64_t(width) + uint64_t(gridPos.x)) * 4u + uint64_t(action));
+	lastTimeMs = timeMs;
+}
+
+const std::vector<unsigned char>& Replay::GetBytes() const
+{
+	return bytes;
+}
+
+bool Replay::Save(const std::string& path) const
+{
+	FILE* const pFile = std::fopen(path.c_str(), "wb");
+	if (pFile == nullptr)
+	{
+		return false;
+	}
+	const bool written = std::fwrite(bytes.data(), 1, bytes.size(), pFile) == bytes.size();
+	return std::fclose(pFile) == 0 && written;
+}
+
+std::unique_ptr<Replay> Replay::Load(const std::string& path)
+{
+	FILE* const pFile = std::fopen(path.c_str(), "rb");
+	if (pFile == nullptr)
+	{
+		return nullptr;
+	}
+	std::vector<unsigned char> bytes;
+	unsigned char buffer[4096];
+	for (size_t nRead; (nRead = std::fread(buffer, 1, sizeof(buffer), pFile)) > 0; )
+	{
+		bytes.insert(bytes.end(), buffer, buffer + nRead);
+	}
+	const bool failed = std::ferror(pFile) != 0;
+	std::fclose(pFile);
+	if (failed)
+	{
+		return nullptr;
+	}
+	return std::unique_ptr<Replay>(new Replay(std::move(bytes)));
+}
+
+bool Replay::ReadField(Field& field) const
+{
+	const unsigned char* p = bytes.data();
+	return ReadHeader(p, field);
+}
+
+bool Replay::ReadHeader(const unsigned char*& p, Field& field) const
+{
+	const unsigned char* const end = bytes.data() + bytes.size();
+
+	// Every value is checked before MineField sees it, since MineField only asserts
+	if (bytes.size() < sizeof(replayMagic) + 1 ||
+		std::memcmp(p, replayMagic, sizeof(replayMagic)) != 0 ||
+		p[sizeof(replayMagic)] != replayVersion)
+	{
+		return false;
+	}
+	p += sizeof(replayMagic) + 1;
+
+	uint64_t width;
+	uint64_t height;
+	uint64_t nMines;
+	uint64_t seed;
+	if (!ReadVarint(p, end, width) || !ReadVarint(p, end, height) ||
+		!ReadVarint(p, end, nMines) || !ReadVarint(p, end, seed) || p == end ||
+		width == 0u || height == 0u || width > uint64_t(maxTiles) || height > uint64_t(maxTiles) ||
+		width * height > uint64_t(maxTiles))
+	{
+		return false;
+	}
+
+	const unsigned char hasSafeStart = *p++;
+	Vei2 safeStart = { 0,0 };
+	if (hasSafeStart == 1u)
+	{
+		uint64_t x;
+		uint64_t y;
+		if (!ReadVarint(p, end, x) || !ReadVarint(p, end, y) || x >= width || y >= height)
+		{
+			return false;
+		}
+		safeStart = { int(x),int(y) };
+	}
+	else if (hasSafeStart != 0u)
+	{
+		return false;
+	}
+	if (nMines == 0u ||
+		nMines > uint64_t(MineField::GetMaxMines(int(width), int(height), hasSafeStart == 1u ? &safeStart : nullptr)))
+	{
+		return false;
+	}
+
+	field.width = int(width);
+	field.height = int(height);
+	field.nMines = int(nMines);
+	field.seed = seed;
+	field.hasSafeStart = hasSafeStart == 1u;
+	field.safeStart = safeStart;
+	return true;
+}
+
+bool Replay::Verify(int width, int height, int nMines, uint32_t& winTimeMs) const
+{
+	Field field;
+	return ReadField(field) && field.width == width && field.height == height && field.nMines == nMines &&
+		Verify(winTimeMs);
+}
+
+bool Replay::Verify(uint32_t& winTimeMs) const
+{
+	const unsigned char* p = bytes.data();
+	const unsigned char* const end = bytes.data() + bytes.size();
+	Field header;
+	if (!ReadHeader(p, header))
+	{
+		return false;
+	}
+	const int nTiles = header.width * header.height;
+
+	MineField field = header.hasSafeStart ?
+		MineField(header.width, header.height, header.nMines, header.seed, header.safeStart) :
+		MineField(header.width, header.height, header.nMines, header.seed);
+
+	// Clicks, nothing may follow the click that ends the game
+	uint64_t timeMs = 0u;
+	while (p < end)
+	{
+		uint64_t delta;
+		uint64_t click;
+		if (field.GetState() != MineField::State::Mineming ||
+			!ReadVarint(p, end, delta) || !ReadVarint(p, end, click) ||
+			click / 4u >= uint64_t(nTiles) || click % 4u > uint64_t(Action::Chord))
+		{
+			return false;
+		}
+		timeMs += delta;
+		if (timeMs > UINT32_MAX)
+		{
+			return false;
+		}
+
+		const int tile = int(click / 4u);
+		const Vei2 gridPos = { tile % header.width, tile / header.width };
+		switch (Action(click % 4u))
+		{
+		case Action::Reveal:
+			field.OnRevealClick(gridPos);
+			break;
+		case Action::Flag:
+			field.OnFlagClick(gridPos);
+			break;
+		case Action::Chord:
+			field.OnChordClick(gridPos);
+			break;
+		}
+	}
+
+	if (field.GetState() != MineField::State::Winrar)
+	{
+		return false;
+	}
+	winTimeMs = uint32_t(timeMs);
+	return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Vei2.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// Every click of one game with its time, kept as a compact byte stream: a header naming
+// the field (size, mines, seed, optional safe start), then two varints per click, the
+// milliseconds since the previous click and tile * 4 + action.
+// Verify() replays the clicks on a fresh field with no rendering or waiting
+class Replay
+{
+public:
+	enum class Action
+	{
+		Reveal,
+		Flag,
+		Chord
+	};
+	// Field a replay is played on, as named by its header
+	struct Field
+	{
+		int width;
+		int height;
+		int nMines;
+		uint64_t seed;
+		bool hasSafeStart;
+		Vei2 safeStart;
+	};
+public:
+	// Replay of the field MineField(width, height, nMines, seed)
+	Replay(int width, int height, int nMines, uint64_t seed);
+	// Replay of the field MineField(width, height, nMines, seed, safeStart)
+	Replay(int width, int height, int nMines, uint64_t seed, const Vei2& safeStart);
+	// Stream received from somewhere else, nothing is trusted until Verify()
+	Replay(std::vector<unsigned char> bytes);
+	// Clicks are added in order, timeMs counts from the start of the game
+	void AddClick(const Vei2& gridPos, Action action, uint32_t timeMs);
+	const std::vector<unsigned char>& GetBytes() const;
+	bool Save(const std::string& path) const;
+	// nullptr when the file cannot be read
+	static std::unique_ptr<Replay> Load(const std::string& path);
+	// Field named by the header. False when the header is malformed or names a field
+	// MineField cannot build, the clicks are only checked by Verify()
+	bool ReadField(Field& field) const;
+	// True when the stream is well formed, every click is inside the field, and the game
+	// is won by the last click. winTimeMs is then the time of that click.
+	// The field comes from the stream itself, a forged 2x1 game verifies as well as an
+	// expert one. Check it with ReadField() or the overload below before ranking a game
+	bool Verify(uint32_t& winTimeMs) const;
+	// Same, and false unless the field is width x height with nMines mines, any seed
+	bool Verify(int width, int height, int nMines, uint32_t& winTimeMs) const;
+
+private:
+	void WriteHeader(int width, int height, int nMines, uint64_t seed, const Vei2* pSafeStart);
+	// Reads the header at p and moves p past it
+	bool ReadHeader(const unsigned char*& p, Field& field) const;
+
+private:
+	// Biggest field Verify() builds, so a forged header cannot ask for any amount of memory
+	static constexpr int maxTiles = 1 << 24;
+	std::vector<unsigned char> bytes;
+	// Field width and time of the last click, for recording
+	int width = 0;
+	uint32_t lastTimeMs = 0u;
+};
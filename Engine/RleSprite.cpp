@@ -0,0 +1,53 @@
+#include "RleSprite.h"
+#include <assert.h>
+
+RleSprite::RleSprite( int width,int height,const Color* pPixels )
+	:
+	width( width ),
+	height( height )
+{
+	assert( width > 0 && width <= 0xFFFF );
+	for( int y = 0; y < height; y++ )
+	{
+		const Color* const pRow = pPixels + y * width;
+		const int countIndex = int( runs.size() );
+		runs.push_back( 0 );
+		for( int x = 0; x < width; )
+		{
+			if( pRow[x].GetX() == 255 )
+			{
+				x++;
+				continue;
+			}
+			const int start = x;
+			while( x < width && pRow[x].GetX() != 255 )
+			{
+				pixels.push_back( pRow[x] );
+				x++;
+			}
+			runs.push_back( (unsigned short)start );
+			runs.push_back( (unsigned short)(x - start) );
+			runs[countIndex]++;
+		}
+	}
+}
+
+int RleSprite::GetWidth() const
+{
+	return width;
+}
+
+int RleSprite::GetHeight() const
+{
+	return height;
+}
+
+const unsigned short* RleSprite::GetRuns() const
+{
+	return runs.data();
+}
+
+const Color* RleSprite::GetPixels() const
+{
+	return pixels.data();
+}
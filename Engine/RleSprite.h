@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Colors.h"
+#include <vector>
+
+// Sprite stored as the opaque spans of each row, so drawing it costs only its visible
+// pixels. Built once from a pixel block where an X byte of 255 marks transparency
+class RleSprite
+{
+public:
+	RleSprite( int width,int height,const Color* pPixels );
+	int GetWidth() const;
+	int GetHeight() const;
+	// every row is a span count followed by the x offset and length of each span
+	const unsigned short* GetRuns() const;
+	// the pixels of all spans, back to back in drawing order
+	const Color* GetPixels() const;
+private:
+	int width;
+	int height;
+	std::vector<unsigned short> runs;
+	std::vector<Color> pixels;
+};
@@ -0,0 +1,523 @@
+#include "Solver.h"
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+
+// Index of the lowest set bit of a non-zero word (de Bruijn multiplication)
+static int LowestBit(uint64_t w)
+{
+	static const int table[64] = {
+		0, 47,  1, 56, 48, 27,  2, 60, 57, 49, 41, 37, 28, 16,  3, 61,
+		54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11,  4, 62,
+		46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+		25, 39, 14, 33, 19, 30,  9, 24, 13, 18,  8, 12,  7,  6,  5, 63 };
+	return table[((w ^ (w - 1)) * 0x03F79D71B4CB0A89ull) >> 58];
+}
+
+void Solver::Reset(const MineField& field)
+{
+	pField = &field;
+	width = field.GetWidth();
+	height = field.GetHeight();
+	seed = field.GetSeed();
+
+	const int nTiles = width * height;
+	nKnownMines = 0;
+	nUnknown = nTiles;
+	nPendingSafe = 0;
+
+	knowledge.assign(nTiles, Knowledge::Unknown);
+	seenRevealed.assign(field.GetRevealedPlane().GetWordCount(), 0u);
+	dirty.clear();
+	isDirty.assign(nTiles, 0u);
+	frontier.clear();
+	onFrontier.assign(nTiles, 0u);
+	safeTiles.clear();
+	mineTiles.clear();
+	varIndex.assign(nTiles, -1);
+}
+
+void Solver::Update(const MineField& field)
+{
+	if (pField != &field || width != field.GetWidth() || height != field.GetHeight() ||
+		seed != field.GetSeed())
+	{
+		Reset(field);
+	}
+
+	// Find the tiles revealed since the last update by diffing the revealed plane
+	const BitPlane& revealed = field.GetRevealedPlane();
+	bool changed = false;
+	for (int w = 0; w < revealed.GetWordCount(); w++)
+	{
+		const uint64_t now = revealed.GetWord(w);
+		if ((seenRevealed[w] & ~now) != 0u)
+		{
+			// Tiles got hidden again, so this is not the game we were following
+			Reset(field);
+			Update(field);
+			return;
+		}
+
+		for (uint64_t fresh = now & ~seenRevealed[w]; fresh != 0u; fresh &= fresh - 1u)
+		{
+			OnRevealed(w * 64 + LowestBit(fresh));
+			changed = true;
+		}
+		seenRevealed[w] = now;
+	}
+
+	if (!changed)
+	{
+		return;
+	}
+
+	// Cheap rules first. The expensive ones only run when the cheap ones leave no
+	// safe tile to play, a bot revealing safe tiles one by one never pays for them
+	ApplySinglePoint();
+	while (nPendingSafe == 0 && (ApplySubset() || ApplyGlobalCount() || ApplyLinearReduction()))
+	{
+		ApplySinglePoint();
+	}
+}
+
+Solver::Knowledge Solver::GetKnowledge(const Vei2& gridPos) const
+{
+	return knowledge[gridPos.y * width + gridPos.x];
+}
+
+const std::vector<int>& Solver::GetSafeTiles() const
+{
+	return safeTiles;
+}
+
+const std::vector<int>& Solver::GetMineTiles() const
+{
+	return mineTiles;
+}
+
+void Solver::OnRevealed(int i)
+{
+	if (knowledge[i] == Knowledge::Unknown)
+	{
+		knowledge[i] = Knowledge::Safe;
+		nUnknown--;
+	}
+	else if (knowledge[i] == Knowledge::Safe)
+	{
+		// One of our deductions got played
+		nPendingSafe--;
+	}
+
+	// The new number is a constraint of its own, and its neighbors lost an unknown tile
+	Queue(i);
+	QueueNeighbors(i);
+}
+
+void Solver::MarkKnown(int i, Knowledge k)
+{
+	assert(knowledge[i] == Knowledge::Unknown);
+	assert(k != Knowledge::Unknown);
+
+	knowledge[i] = k;
+	nUnknown--;
+
+	if (k == Knowledge::Mine)
+	{
+		nKnownMines++;
+		mineTiles.push_back(i);
+	}
+	else
+	{
+		safeTiles.push_back(i);
+		nPendingSafe++;
+	}
+
+	QueueNeighbors(i);
+}
+
+void Solver::QueueNeighbors(int i)
+{
+	const int x = i % width;
+	const int y = i / width;
+	const int xStart = std::max(0, x - 1);
+	const int yStart = std::max(0, y - 1);
+	const int xEnd = std::min(width - 1, x + 1);
+	const int yEnd = std::min(height - 1, y + 1);
+
+	for (Vei2 pos = { xStart,yStart }; pos.y <= yEnd; pos.y++)
+	{
+		for (pos.x = xStart; pos.x <= xEnd; pos.x++)
+		{
+			if (pField->IsRevealed(pos))
+			{
+				Queue(pos.y * width + pos.x);
+			}
+		}
+	}
+}
+
+void Solver::Queue(int i)
+{
+	if (!isDirty[i])
+	{
+		isDirty[i] = 1u;
+		dirty.push_back(i);
+	}
+}
+
+bool Solver::BuildConstraint(int i, Constraint& constraint) const
+{
+	const Vei2 gridPos = { i % width, i / width };
+	const int xStart = std::max(0, gridPos.x - 1);
+	const int yStart = std::max(0, gridPos.y - 1);
+	const int xEnd = std::min(width - 1, gridPos.x + 1);
+	const int yEnd = std::min(height - 1, gridPos.y + 1);
+
+	constraint.nTiles = 0;
+	constraint.nMines = pField->GetNeighborBombCount(gridPos);
+
+	for (int y = yStart; y <= yEnd; y++)
+	{
+		for (int x = xStart; x <= xEnd; x++)
+		{
+			const int n = y * width + x;
+			if (knowledge[n] == Knowledge::Mine)
+			{
+				constraint.nMines--;
+			}
+			else if (knowledge[n] == Knowledge::Unknown)
+			{
+				constraint.tiles[constraint.nTiles++] = n;
+			}
+		}
+	}
+
+	return constraint.nTiles > 0;
+}
+
+bool Solver::ApplySinglePoint()
+{
+	bool progress = false;
+	Constraint c;
+
+	// Marking tiles queues their neighbors, so this runs until nothing more follows
+	while (!dirty.empty())
+	{
+		const int i = dirty.back();
+		dirty.pop_back();
+		isDirty[i] = 0u;
+
+		if (!BuildConstraint(i, c))
+		{
+			continue;
+		}
+
+		if (c.nMines == 0 || c.nMines == c.nTiles)
+		{
+			// Either none or all of the unknown neighbors are mines
+			const Knowledge k = c.nMines == 0 ? Knowledge::Safe : Knowledge::Mine;
+			for (int t = 0; t < c.nTiles; t++)
+			{
+				MarkKnown(c.tiles[t], k);
+			}
+			progress = true;
+		}
+		else if (!onFrontier[i])
+		{
+			onFrontier[i] = 1u;
+			frontier.push_back(i);
+		}
+	}
+
+	return progress;
+}
+
+bool Solver::ApplySubset()
+{
+	bool progress = false;
+	Constraint a;
+	Constraint b;
+
+	for (size_t f = 0; f < frontier.size(); f++)
+	{
+		const int i = frontier[f];
+		if (!BuildConstraint(i, a))
+		{
+			// Fully solved around this number, drop it from the frontier
+			onFrontier[i] = 0u;
+			frontier[f--] = frontier.back();
+			frontier.pop_back();
+			continue;
+		}
+
+		// Only numbers up to two tiles away can share unknown neighbors
+		const int x = i % width;
+		const int y = i / width;
+		bool deduced = false;
+		for (int by = std::max(0, y - 2); by <= std::min(height - 1, y + 2) && !deduced; by++)
+		{
+			for (int bx = std::max(0, x - 2); bx <= std::min(width - 1, x + 2) && !deduced; bx++)
+			{
+				const int j = by * width + bx;
+				if (j == i || !onFrontier[j] || !BuildConstraint(j, b) || b.nTiles <= a.nTiles)
+				{
+					continue;
+				}
+
+				// If a's unknowns are a subset of b's, the rest of b holds b - a mines
+				int nShared = 0;
+				for (int s = 0; s < a.nTiles; s++)
+				{
+					nShared += int(std::find(b.tiles, b.tiles + b.nTiles, a.tiles[s]) != b.tiles + b.nTiles);
+				}
+				if (nShared != a.nTiles)
+				{
+					continue;
+				}
+
+				const int nRestMines = b.nMines - a.nMines;
+				const int nRestTiles = b.nTiles - a.nTiles;
+				if (nRestMines == 0 || nRestMines == nRestTiles)
+				{
+					const Knowledge k = nRestMines == 0 ? Knowledge::Safe : Knowledge::Mine;
+					for (int t = 0; t < b.nTiles; t++)
+					{
+						if (std::find(a.tiles, a.tiles + a.nTiles, b.tiles[t]) == a.tiles + a.nTiles)
+						{
+							MarkKnown(b.tiles[t], k);
+						}
+					}
+					// a is stale now, move on to the next number
+					deduced = true;
+					progress = true;
+				}
+			}
+		}
+	}
+
+	return progress;
+}
+
+bool Solver::ApplyGlobalCount()
+{
+	// When the remaining mine count settles every unknown tile at once
+	const int nRemaining = pField->GetMineCount() - nKnownMines;
+	if (nUnknown == 0 || (nRemaining != 0 && nRemaining != nUnknown))
+	{
+		return false;
+	}
+
+	const Knowledge k = nRemaining == 0 ? Knowledge::Safe : Knowledge::Mine;
+	for (int i = 0; i < int(knowledge.size()); i++)
+	{
+		if (knowledge[i] == Knowledge::Unknown)
+		{
+			MarkKnown(i, k);
+		}
+	}
+	return true;
+}
+
+bool Solver::ApplyLinearReduction()
+{
+	constraints.clear();
+	for (int i : frontier)
+	{
+		Constraint c;
+		if (BuildConstraint(i, c))
+		{
+			constraints.push_back(c);
+		}
+	}
+	if (constraints.empty())
+	{
+		return false;
+	}
+
+	// Split the frontier into parts that share no unknown tile: union-find over the
+	// constraints, with varIndex remembering the first constraint that used each tile
+	const int nRows = int(constraints.size());
+	componentOf.resize(nRows);
+	for (int r = 0; r < nRows; r++)
+	{
+		componentOf[r] = r;
+	}
+	auto find = [this](int r)
+	{
+		while (componentOf[r] != r)
+		{
+			r = componentOf[r] = componentOf[componentOf[r]];
+		}
+		return r;
+	};
+
+	vars.clear();
+	for (int r = 0; r < nRows; r++)
+	{
+		for (int t = 0; t < constraints[r].nTiles; t++)
+		{
+			const int tile = constraints[r].tiles[t];
+			if (varIndex[tile] == -1)
+			{
+				varIndex[tile] = r;
+				vars.push_back(tile);
+			}
+			else
+			{
+				componentOf[find(r)] = find(varIndex[tile]);
+			}
+		}
+	}
+	for (int tile : vars)
+	{
+		varIndex[tile] = -1;
+	}
+
+	componentRows.resize(nRows);
+	for (int r = 0; r < nRows; r++)
+	{
+		componentRows[r] = r;
+	}
+	std::sort(componentRows.begin(), componentRows.end(),
+		[&find](int lhs, int rhs) { return find(lhs) < find(rhs); });
+
+	bool progress = false;
+	for (int start = 0; start < nRows;)
+	{
+		int end = start + 1;
+		while (end < nRows && find(componentRows[end]) == find(componentRows[start]))
+		{
+			end++;
+		}
+
+		rowScratch.assign(componentRows.begin() + start, componentRows.begin() + end);
+		progress |= ReduceComponent(rowScratch);
+		start = end;
+	}
+
+	return progress;
+}
+
+bool Solver::ReduceComponent(const std::vector<int>& rows)
+{
+	// Number the unknown tiles of this part of the frontier
+	vars.clear();
+	for (int r : rows)
+	{
+		for (int t = 0; t < constraints[r].nTiles; t++)
+		{
+			const int tile = constraints[r].tiles[t];
+			if (varIndex[tile] == -1)
+			{
+				varIndex[tile] = int(vars.size());
+				vars.push_back(tile);
+			}
+		}
+	}
+
+	const int nRows = int(rows.size());
+	const int nVars = int(vars.size());
+	bool progress = false;
+
+	if (nVars <= maxLinearVariables && nRows > 1)
+	{
+		// One row per number: sum of its unknown tiles = mines left around it
+		const int stride = nVars + 1;
+		matrix.assign(size_t(nRows) * stride, 0.0);
+		for (int r = 0; r < nRows; r++)
+		{
+			const Constraint& c = constraints[rows[r]];
+			for (int t = 0; t < c.nTiles; t++)
+			{
+				matrix[r * stride + varIndex[c.tiles[t]]] = 1.0;
+			}
+			matrix[r * stride + nVars] = double(c.nMines);
+		}
+
+		// Reduced row echelon form with partial pivoting
+		const double eps = 1e-9;
+		int pivotRow = 0;
+		for (int col = 0; col < nVars && pivotRow < nRows; col++)
+		{
+			int best = pivotRow;
+			for (int r = pivotRow + 1; r < nRows; r++)
+			{
+				if (std::abs(matrix[r * stride + col]) > std::abs(matrix[best * stride + col]))
+				{
+					best = r;
+				}
+			}
+			if (std::abs(matrix[best * stride + col]) < eps)
+			{
+				continue;
+			}
+			if (best != pivotRow)
+			{
+				std::swap_ranges(matrix.begin() + best * stride, matrix.begin() + (best + 1) * stride,
+					matrix.begin() + pivotRow * stride);
+			}
+
+			const double inv = 1.0 / matrix[pivotRow * stride + col];
+			for (int k = col; k < stride; k++)
+			{
+				matrix[pivotRow * stride + k] *= inv;
+			}
+			for (int r = 0; r < nRows; r++)
+			{
+				const double factor = matrix[r * stride + col];
+				if (r != pivotRow && std::abs(factor) > eps)
+				{
+					for (int k = col; k < stride; k++)
+					{
+						matrix[r * stride + k] -= factor * matrix[pivotRow * stride + k];
+					}
+				}
+			}
+			pivotRow++;
+		}
+
+		// Every tile is 0 or 1, so a row whose right side equals the largest (or smallest)
+		// value its left side can take fixes all of its tiles
+		for (int r = 0; r < pivotRow; r++)
+		{
+			const double* row = &matrix[r * stride];
+			double maxSum = 0.0;
+			double minSum = 0.0;
+			for (int k = 0; k < nVars; k++)
+			{
+				if (row[k] > eps)
+				{
+					maxSum += row[k];
+				}
+				else if (row[k] < -eps)
+				{
+					minSum += row[k];
+				}
+			}
+
+			const bool atMax = std::abs(row[nVars] - maxSum) < eps;
+			const bool atMin = std::abs(row[nVars] - minSum) < eps;
+			if (!atMax && !atMin)
+			{
+				continue;
+			}
+
+			for (int k = 0; k < nVars; k++)
+			{
+				if (std::abs(row[k]) > eps && knowledge[vars[k]] == Knowledge::Unknown)
+				{
+					const bool isMine = (row[k] > 0.0) == atMax;
+					MarkKnown(vars[k], isMine ? Knowledge::Mine : Knowledge::Safe);
+					progress = true;
+				}
+			}
+		}
+	}
+
+	for (int tile : vars)
+	{
+		varIndex[tile] = -1;
+	}
+	return progress;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "MineField.h"
+#include "BitPlane.h"
+#include <vector>
+#include <stdint.h>
+
+// Deduces certain-safe and certain-mine tiles from the numbers revealed on a MineField.
+// Rules are tried from cheapest to most expensive: single-point rules on one number,
+// the subset rule on pairs of nearby numbers, then linear reduction of every connected
+// part of the frontier.
+// Update() is incremental: it only looks at tiles revealed since the previous call, and
+// all working buffers are kept between calls. Flags placed by the player are ignored,
+// the solver only trusts its own deductions
+class Solver
+{
+public:
+	enum class Knowledge : unsigned char
+	{
+		Unknown,
+		Safe,
+		Mine
+	};
+
+public:
+	// Starts over on a new field. Update() calls this itself when the field changes
+	void Reset(const MineField& field);
+	// Catches up with the tiles revealed on field and deduces as much as possible.
+	// Subset and linear rules are skipped while proven safe tiles are still unrevealed
+	void Update(const MineField& field);
+	Knowledge GetKnowledge(const Vei2& gridPos) const;
+	// Every tile proven safe, in the order found (revealed ones are not removed)
+	const std::vector<int>& GetSafeTiles() const;
+	// Every tile proven to be a mine, in the order found
+	const std::vector<int>& GetMineTiles() const;
+
+private:
+	// Hidden neighbors that are still unknown and the number of mines among them
+	class Constraint
+	{
+	public:
+		int nTiles = 0;
+		int tiles[8];
+		int nMines = 0;
+	};
+
+private:
+	void OnRevealed(int i);
+	void MarkKnown(int i, Knowledge knowledge);
+	void QueueNeighbors(int i);
+	void Queue(int i);
+	bool BuildConstraint(int i, Constraint& constraint) const;
+	bool ApplySinglePoint();
+	bool ApplySubset();
+	bool ApplyGlobalCount();
+	bool ApplyLinearReduction();
+	bool ReduceComponent(const std::vector<int>& rows);
+
+private:
+	// Largest frontier part (in unknown tiles) that linear reduction is tried on
+	static constexpr int maxLinearVariables = 256;
+
+	const MineField* pField = nullptr;
+	int width = 0;
+	int height = 0;
+	uint64_t seed = 0;
+	int nKnownMines = 0;
+	int nUnknown = 0;
+	// Tiles proven safe that are not revealed yet
+	int nPendingSafe = 0;
+
+	std::vector<Knowledge> knowledge;
+	// Revealed plane as of the previous Update(), diffed word by word to find new reveals
+	std::vector<uint64_t> seenRevealed;
+
+	// Revealed numbers whose neighborhood changed and need the single-point rules
+	std::vector<int> dirty;
+	std::vector<unsigned char> isDirty;
+	// Revealed numbers that still have unknown neighbors
+	std::vector<int> frontier;
+	std::vector<unsigned char> onFrontier;
+
+	std::vector<int> safeTiles;
+	std::vector<int> mineTiles;
+
+	// Scratch space for linear reduction
+	std::vector<int> varIndex;
+	std::vector<int> vars;
+	std::vector<int> componentOf;
+	std::vector<int> componentRows;
+	std::vector<int> rowScratch;
+	std::vector<double> matrix;
+	std::vector<Constraint> constraints;
+};
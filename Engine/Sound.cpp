@@ -19,6 +19,7 @@
  *	along with this source code.  If not, see <http://www.gnu.org/licenses/>.			  *
  ******************************************************************************************/
 #include "Sound.h"
+#ifndef CHILI_HEADLESS
 #include <assert.h>
 #include <algorithm>
 #include <fstream>
@@ -731,4 +732,5 @@ std::wstring SoundSystem::FileException::GetFullMessage() const
 std::wstring SoundSystem::FileException::GetExceptionType() const
 {
 	return L"Sound System File Exception";
-}
\ No newline at end of file
+}
+#endif
@@ -19,6 +19,33 @@
  *	along with this source code.  If not, see <http://www.gnu.org/licenses/>.			  *
  ******************************************************************************************/
 #pragma once
+#ifdef CHILI_HEADLESS
+#include <string>
+
+// Silent stand-in with the same interface for headless builds, where there is no XAudio
+class Sound
+{
+public:
+	enum class LoopType
+	{
+		NotLooping,
+		AutoEmbeddedCuePoints,
+		AutoFullSound,
+		ManualFloat,
+		ManualSample,
+		Invalid
+	};
+public:
+	Sound() = default;
+	Sound( const std::wstring&,bool ) {}
+	Sound( const std::wstring&,LoopType = LoopType::NotLooping ) {}
+	Sound( const std::wstring&,unsigned int,unsigned int ) {}
+	Sound( const std::wstring&,float,float ) {}
+	void Play( float = 1.0f,float = 1.0f ) {}
+	void StopOne() {}
+	void StopAll() {}
+};
+#else
 #include "ChiliWin.h"
 #include <memory>
 #include <vector>
@@ -169,4 +196,5 @@ private:
 	std::vector<SoundSystem::Channel*> activeChannelPtrs;
 	static constexpr unsigned int nullSample = 0xFFFFFFFFu;
 	static constexpr float nullSeconds = -1.0f;
-};
\ No newline at end of file
+};
+#endif
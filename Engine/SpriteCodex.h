@@ -2,9 +2,33 @@
 
 #include "Graphics.h"
 #include "Vei2.h"
+#include "RleSprite.h"
+#include <vector>
 
 class SpriteCodex
 {
+public:
+	// Every look a field tile can have, composed over the base color once at startup.
+	// Number0-Number8 are 0-8 so a neighbor count converts directly
+	enum class TileVariant
+	{
+		Number0 = 0,
+		Number1,
+		Number2,
+		Number3,
+		Number4,
+		Number5,
+		Number6,
+		Number7,
+		Number8,
+		Button,
+		Flagged,
+		Bomb,
+		BombFlagged,
+		BombCrossed,
+		BombRed,
+		Count
+	};
 public:
 	// width and height of all tiles
 	static constexpr int tileSize = 16;
@@ -29,4 +53,38 @@ public:
 	static void DrawTileNumber( const Vei2& pos,int n,Graphics& gfx );
 	// Win Screen 254x192 center origin
 	static void DrawWin( const Vei2& pos,Graphics& gfx );
+	// Opaque 16x16 tile from the cache, top left origin, no background needed
+	static void DrawTile( TileVariant variant,const Vei2& pos,Graphics& gfx );
+private:
+	// sprites live in one atlas, each cropped to the pixels it draws
+	struct Sprite
+	{
+		int left;
+		int top;
+		int width;
+		int height;
+		int pixelOffset;
+		int paletteOffset;
+	};
+	enum SpriteIndex
+	{
+		Tile0 = 0,
+		Button = 9,
+		Cross,
+		Flag,
+		Bomb,
+		BombRed,
+		Win
+	};
+	static void DrawSprite( int index,const Vei2& pos,Graphics& gfx );
+	// for the mostly empty sprites, skips their transparent pixels entirely
+	static void DrawSpriteRle( int index,const Vei2& pos,Graphics& gfx );
+	static std::vector<Color> ExpandAtlas();
+	static std::vector<RleSprite> EncodeRle();
+	static std::vector<Color> ComposeTiles();
+	static void ComposeSprite( int index,Color* pTile );
+	static const Sprite sprites[];
+	static const std::vector<Color> atlas;
+	static const std::vector<Color> tileCache;
+	static const std::vector<RleSprite> rleSprites;
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// LEB128 variable-length integers: 7 bits per byte, low bits first, high bit set on
+// every byte but the last. Small values take one byte
+inline void WriteVarint(std::vector<unsigned char>& out, uint64_t value)
+{
+	while (value >= 0x80u)
+	{
+		out.push_back((unsigned char)(value | 0x80u));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+// Reads one value and moves p past it. False when the bytes end before the value
+// does or the value does not fit 64 bits
+inline bool ReadVarint(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+{
+	value = 0u;
+	for (int shift = 0; p < end && shift < 64; shift += 7)
+	{
+		const unsigned char byte = *p++;
+		value |= uint64_t(byte & 0x7Fu) << shift;
+		if (byte < 0x80u)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,63 @@
+#include "Xoshiro256.h"
+#include <assert.h>
+#include <random>
+
+static uint64_t RotateLeft(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+Xoshiro256::Xoshiro256(uint64_t seed)
+{
+	// Expand the 64-bit seed into the full state with splitmix64,
+	// this never produces the all-zero state
+	for (uint64_t& s : state)
+	{
+		seed += 0x9E3779B97F4A7C15ull;
+		uint64_t z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		s = z ^ (z >> 31);
+	}
+}
+
+uint64_t Xoshiro256::operator()()
+{
+	const uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+	const uint64_t t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = RotateLeft(state[3], 45);
+
+	return result;
+}
+
+uint32_t Xoshiro256::Bounded(uint32_t bound)
+{
+	assert(bound > 0u);
+
+	// Lemire's multiply-shift with rejection: no division in the common case
+	// and no modulo bias
+	uint64_t m = uint64_t(uint32_t((*this)() >> 32)) * bound;
+	uint32_t low = uint32_t(m);
+	if (low < bound)
+	{
+		const uint32_t threshold = (0u - bound) % bound;
+		while (low < threshold)
+		{
+			m = uint64_t(uint32_t((*this)() >> 32)) * bound;
+			low = uint32_t(m);
+		}
+	}
+	return uint32_t(m >> 32);
+}
+
+uint64_t Xoshiro256::MakeRandomSeed()
+{
+	std::random_device rd;
+	return (uint64_t(rd()) << 32) ^ uint64_t(rd());
+}
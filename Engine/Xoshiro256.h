@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// xoshiro256** random number generator (32 bytes of state instead of the 2.5KB of std::mt19937).
+// The output sequence for a given seed is the same on every platform and compiler,
+// so anything generated from a seed can be regenerated from it
+class Xoshiro256
+{
+public:
+	// Makes Xoshiro256 usable as a UniformRandomBitGenerator with the std distributions
+	typedef uint64_t result_type;
+public:
+	Xoshiro256(uint64_t seed);
+	uint64_t operator()();
+	// Uniform integer in [0, bound), bound must be > 0
+	uint32_t Bounded(uint32_t bound);
+	// Seed from the system entropy source for when reproducibility is not needed
+	static uint64_t MakeRandomSeed();
+	static constexpr uint64_t min()
+	{
+		return 0u;
+	}
+	static constexpr uint64_t max()
+	{
+		return ~uint64_t(0);
+	}
+private:
+	uint64_t state[4];
+};
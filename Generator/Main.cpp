@@ -0,0 +1,169 @@
+// Generates a pool of no-guess MineField boards: fields that the Solver can clear
+// from the first click alone. Prints one seed per line, each board is rebuilt with
+// MineField(width, height, mines, seed, { x,y }) and starts with a reveal at x,y.
+//
+// Usage: Generator [--count N] [--width W] [--height H] [--mines M]
+//                  [--x X] [--y Y] [--threads T] [--seed S] [--stats 0|1]
+//                  [--max-candidates C]
+//
+// With --stats 1 every line also holds the board's 3BV, openings and islands.
+// The first click defaults to the center of the field. The same options always
+// print the same seeds, whatever the thread count. At most C candidates are tried,
+// 1000 per board by default; when fewer than N boards pass, the ones found are
+// printed and the exit code is 1
+#include "BoardStats.h"
+#include "NoGuessGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	struct Options
+	{
+		int count = 1000;
+		int width = 30;
+		int height = 16;
+		int nMines = 99;
+		int x = -1;
+		int y = -1;
+		int nThreads = 0;
+		uint64_t seed = 0;
+		bool stats = false;
+		long long maxCandidates = 0;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "Missing value for %s\n", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--count") == 0)
+			{
+				options.count = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--width") == 0)
+			{
+				options.width = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--height") == 0)
+			{
+				options.height = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--mines") == 0)
+			{
+				options.nMines = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--x") == 0)
+			{
+				options.x = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--y") == 0)
+			{
+				options.y = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--threads") == 0)
+			{
+				options.nThreads = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--seed") == 0)
+			{
+				options.seed = std::strtoull(value, nullptr, 10);
+			}
+			else if (std::strcmp(arg, "--stats") == 0)
+			{
+				options.stats = std::atoi(value) != 0;
+			}
+			else if (std::strcmp(arg, "--max-candidates") == 0)
+			{
+				options.maxCandidates = std::atoll(value);
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", arg);
+				return false;
+			}
+		}
+
+		if (options.x < 0)
+		{
+			options.x = options.width / 2;
+		}
+		if (options.y < 0)
+		{
+			options.y = options.height / 2;
+		}
+		if (options.maxCandidates <= 0)
+		{
+			options.maxCandidates = 1000LL * options.count;
+		}
+
+		// The first click and its neighbors are kept free of mines
+		const Vei2 firstClick = { options.x,options.y };
+		if (options.count <= 0 || options.width <= 0 || options.height <= 0 ||
+			options.x >= options.width || options.y >= options.height ||
+			options.nMines <= 0 || options.nMines > MineField::GetMaxMines(options.width, options.height, &firstClick))
+		{
+			std::fprintf(stderr, "Invalid board count, field size or first click\n");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	NoGuessGenerator generator(options.width, options.height, options.nMines, { options.x,options.y });
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const std::vector<uint64_t> seeds = generator.Generate(options.seed, options.count, options.maxCandidates, options.nThreads);
+	const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - start;
+
+	if (options.stats)
+	{
+		const std::vector<BoardStats> stats = BoardStats::ComputeBatch(options.width, options.height,
+			options.nMines, seeds, { options.x,options.y }, options.nThreads);
+		for (size_t i = 0; i < seeds.size(); i++)
+		{
+			std::printf("%llu %d %d %d\n", (unsigned long long)seeds[i],
+				stats[i].Get3BV(), stats[i].GetOpeningCount(), stats[i].GetIslandCount());
+		}
+	}
+	else
+	{
+		for (uint64_t seed : seeds)
+		{
+			std::printf("%llu\n", (unsigned long long)seed);
+		}
+	}
+
+	std::fprintf(stderr, "Field:        %dx%d, %d mines, first click %d,%d\n",
+		options.width, options.height, options.nMines, options.x, options.y);
+	std::fprintf(stderr, "Boards:       %d of %d from %lld candidates (%.2f%% pass)\n", int(seeds.size()),
+		options.count, generator.GetCandidateCount(),
+		100.0 * double(seeds.size()) / double(std::max(1LL, generator.GetCandidateCount())));
+	std::fprintf(stderr, "Wall time:    %.3f s\n", wallTime.count());
+	std::fprintf(stderr, "Boards/sec:   %.1f\n", double(seeds.size()) / wallTime.count());
+
+	if (int(seeds.size()) < options.count)
+	{
+		std::fprintf(stderr, "Too few boards pass, try fewer mines or a higher --max-candidates\n");
+		return 1;
+	}
+	return 0;
+}
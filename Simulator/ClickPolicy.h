@@ -0,0 +1,30 @@
+#pragma once
+
+#include "MineField.h"
+
+// Decides the next click of a simulated player. The simulator gives every worker
+// thread its own policy object, so a policy can keep state between clicks
+class ClickPolicy
+{
+public:
+	class Click
+	{
+	public:
+		enum class Type
+		{
+			Reveal,
+			Flag,
+			Chord
+		};
+	public:
+		Type type;
+		Vei2 gridPos;
+	};
+
+public:
+	virtual ~ClickPolicy() = default;
+	// Called once before the first click of every game
+	virtual void OnNewGame(const MineField& field) = 0;
+	// Only called while the game is still running
+	virtual Click NextClick(const MineField& field) = 0;
+};
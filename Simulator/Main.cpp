@@ -0,0 +1,214 @@
+// Headless batch simulator: plays many games of MineField with a click policy on all cores
+// and reports throughput, win rate and per-game latency.
+//
+// Usage: Simulator [--games N] [--width W] [--height H] [--mines M]
+//                  [--threads T] [--seed S] [--policy random|solver|probability]
+//
+// Game i is always played on the field seeded with seed + i, so a run gives the
+// same win rate whatever the thread count
+#include "MineField.h"
+#include "RandomClickPolicy.h"
+#include "SolverClickPolicy.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct Options
+	{
+		long long nGames = 100000;
+		int width = 30;
+		int height = 16;
+		int nMines = 99;
+		int nThreads = 0;
+		uint64_t seed = 0;
+		std::string policy = "random";
+	};
+
+	// Results of one worker thread
+	struct Shard
+	{
+		long long nWins = 0;
+		std::vector<float> latencies;
+	};
+
+	std::unique_ptr<ClickPolicy> MakePolicy(const std::string& name, uint64_t seed)
+	{
+		if (name == "random")
+		{
+			return std::unique_ptr<ClickPolicy>(new RandomClickPolicy(seed));
+		}
+		if (name == "solver")
+		{
+			return std::unique_ptr<ClickPolicy>(new SolverClickPolicy(seed));
+		}
+		if (name == "probability")
+		{
+			return std::unique_ptr<ClickPolicy>(new SolverClickPolicy(seed, true));
+		}
+		return nullptr;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "Missing value for %s\n", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--games") == 0)
+			{
+				options.nGames = std::atoll(value);
+			}
+			else if (std::strcmp(arg, "--width") == 0)
+			{
+				options.width = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--height") == 0)
+			{
+				options.height = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--mines") == 0)
+			{
+				options.nMines = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--threads") == 0)
+			{
+				options.nThreads = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--seed") == 0)
+			{
+				options.seed = std::strtoull(value, nullptr, 10);
+			}
+			else if (std::strcmp(arg, "--policy") == 0)
+			{
+				options.policy = value;
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", arg);
+				return false;
+			}
+		}
+
+		if (options.nGames <= 0 || options.width <= 0 || options.height <= 0 ||
+			options.nMines <= 0 || options.nMines >= options.width * options.height)
+		{
+			std::fprintf(stderr, "Invalid game count or field size\n");
+			return false;
+		}
+		if (!MakePolicy(options.policy, 0))
+		{
+			std::fprintf(stderr, "Unknown policy %s\n", options.policy.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	// Plays games firstGame, firstGame + stride, ... of the run
+	void RunShard(const Options& options, long long firstGame, long long stride, Shard& shard)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		std::unique_ptr<ClickPolicy> pPolicy = MakePolicy(options.policy, options.seed);
+		shard.latencies.reserve(size_t(options.nGames / stride + 1));
+
+		for (long long game = firstGame; game < options.nGames; game += stride)
+		{
+			const Clock::time_point start = Clock::now();
+
+			MineField field(options.width, options.height, options.nMines, options.seed + uint64_t(game));
+			pPolicy->OnNewGame(field);
+			while (field.GetState() == MineField::State::Mineming)
+			{
+				const ClickPolicy::Click click = pPolicy->NextClick(field);
+				switch (click.type)
+				{
+				case ClickPolicy::Click::Type::Reveal:
+					field.OnRevealClick(click.gridPos);
+					break;
+				case ClickPolicy::Click::Type::Flag:
+					field.OnFlagClick(click.gridPos);
+					break;
+				case ClickPolicy::Click::Type::Chord:
+					field.OnChordClick(click.gridPos);
+					break;
+				}
+			}
+
+			const std::chrono::duration<float, std::micro> latency = Clock::now() - start;
+			shard.latencies.push_back(latency.count());
+			if (field.GetState() == MineField::State::Winrar)
+			{
+				shard.nWins++;
+			}
+		}
+	}
+
+	float Percentile(const std::vector<float>& sorted, double p)
+	{
+		const size_t i = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+		return sorted[i];
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	int nThreads = options.nThreads > 0 ? options.nThreads : int(std::thread::hardware_concurrency());
+	nThreads = int(std::max(1ll, std::min<long long>(nThreads, options.nGames)));
+
+	// Interleave the games over the threads so every shard gets the same mix of seeds
+	std::vector<Shard> shards(nThreads);
+	std::vector<std::thread> workers;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int t = 0; t < nThreads; t++)
+	{
+		workers.emplace_back(RunShard, std::cref(options), (long long)t, (long long)nThreads, std::ref(shards[t]));
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - start;
+
+	long long nWins = 0;
+	std::vector<float> latencies;
+	latencies.reserve(size_t(options.nGames));
+	for (const Shard& shard : shards)
+	{
+		nWins += shard.nWins;
+		latencies.insert(latencies.end(), shard.latencies.begin(), shard.latencies.end());
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	std::printf("Field:        %dx%d, %d mines\n", options.width, options.height, options.nMines);
+	std::printf("Policy:       %s\n", options.policy.c_str());
+	std::printf("Games:        %lld on %d thread(s)\n", options.nGames, nThreads);
+	std::printf("Wall time:    %.3f s\n", wallTime.count());
+	std::printf("Games/sec:    %.0f\n", double(options.nGames) / wallTime.count());
+	std::printf("Win rate:     %.4f%%\n", 100.0 * double(nWins) / double(options.nGames));
+	std::printf("Latency (us): p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+		Percentile(latencies, 0.50), Percentile(latencies, 0.90),
+		Percentile(latencies, 0.99), latencies.back());
+
+	return 0;
+}
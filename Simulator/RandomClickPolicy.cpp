@@ -0,0 +1,51 @@
+#include "RandomClickPolicy.h"
+#include <assert.h>
+
+RandomClickPolicy::RandomClickPolicy(uint64_t seed)
+	:seed(seed),
+	rng(seed)
+{
+}
+
+void RandomClickPolicy::OnNewGame(const MineField& field)
+{
+	// Clicks only depend on the policy seed and the field, not on which games came before.
+	// The salt keeps the click stream apart from the stream that placed the mines
+	rng = Xoshiro256(seed ^ field.GetSeed() ^ 0xD1B54A32D192ED03ull);
+
+	const int nTiles = field.GetWidth() * field.GetHeight();
+
+	candidates.resize(nTiles);
+	for (int i = 0; i < nTiles; i++)
+	{
+		candidates[i] = i;
+	}
+}
+
+ClickPolicy::Click RandomClickPolicy::NextClick(const MineField& field)
+{
+	const int width = field.GetWidth();
+
+	// Once every hidden tile is a bomb the only way left to win is to flag them all
+	const bool onlyBombsLeft = field.GetUnrevealedCount() == field.GetMineCount();
+
+	while (!candidates.empty())
+	{
+		const int slot = int(rng.Bounded(uint32_t(candidates.size())));
+		const Vei2 gridPos = { candidates[slot] % width, candidates[slot] / width };
+
+		if (field.IsRevealed(gridPos) || field.IsFlagged(gridPos))
+		{
+			// Swap-remove tiles that are no longer hidden
+			candidates[slot] = candidates.back();
+			candidates.pop_back();
+			continue;
+		}
+
+		return { onlyBombsLeft ? Click::Type::Flag : Click::Type::Reveal, gridPos };
+	}
+
+	// A running game always has a hidden tile left
+	assert(false);
+	return { Click::Type::Reveal, { 0,0 } };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ClickPolicy.h"
+#include "Xoshiro256.h"
+#include <vector>
+
+// Reveals random hidden tiles, then flags whatever is left once only bombs remain hidden.
+// Serves as the baseline every smarter policy is measured against
+class RandomClickPolicy : public ClickPolicy
+{
+public:
+	RandomClickPolicy(uint64_t seed);
+	void OnNewGame(const MineField& field) override;
+	Click NextClick(const MineField& field) override;
+
+private:
+	uint64_t seed;
+	Xoshiro256 rng;
+	// Tiles that may still be hidden. Revealed and flagged tiles are dropped lazily when picked
+	std::vector<int> candidates;
+};
@@ -0,0 +1,79 @@
+#include "SolverClickPolicy.h"
+#include <assert.h>
+
+SolverClickPolicy::SolverClickPolicy(uint64_t seed, bool useProbabilities)
+	:seed(seed),
+	useProbabilities(useProbabilities),
+	rng(seed)
+{
+}
+
+void SolverClickPolicy::OnNewGame(const MineField& field)
+{
+	// Same salt as RandomClickPolicy, so both guess the same first tile on a field
+	rng = Xoshiro256(seed ^ field.GetSeed() ^ 0xD1B54A32D192ED03ull);
+	solver.Reset(field);
+	nSafePlayed = 0;
+	nMinesFlagged = 0;
+
+	const int nTiles = field.GetWidth() * field.GetHeight();
+	candidates.resize(nTiles);
+	for (int i = 0; i < nTiles; i++)
+	{
+		candidates[i] = i;
+	}
+}
+
+ClickPolicy::Click SolverClickPolicy::NextClick(const MineField& field)
+{
+	const int width = field.GetWidth();
+	solver.Update(field);
+
+	// Reveal a proven safe tile first
+	const std::vector<int>& safeTiles = solver.GetSafeTiles();
+	while (nSafePlayed < safeTiles.size())
+	{
+		const int i = safeTiles[nSafePlayed++];
+		const Vei2 gridPos = { i % width, i / width };
+		if (!field.IsRevealed(gridPos))
+		{
+			return { Click::Type::Reveal, gridPos };
+		}
+	}
+
+	// Then flag proven mines, the game is only won once all of them are flagged
+	const std::vector<int>& mineTiles = solver.GetMineTiles();
+	while (nMinesFlagged < mineTiles.size())
+	{
+		const int i = mineTiles[nMinesFlagged++];
+		const Vei2 gridPos = { i % width, i / width };
+		if (!field.IsFlagged(gridPos))
+		{
+			return { Click::Type::Flag, gridPos };
+		}
+	}
+
+	// Nothing is certain, guess. Falls back to a random tile if the enumeration runs over budget
+	if (useProbabilities && field.GetRevealedPlane().Count() > 0 && probabilities.Compute(field))
+	{
+		return { Click::Type::Reveal, probabilities.GetSafestTile() };
+	}
+	while (!candidates.empty())
+	{
+		const int slot = int(rng.Bounded(uint32_t(candidates.size())));
+		const Vei2 gridPos = { candidates[slot] % width, candidates[slot] / width };
+
+		if (solver.GetKnowledge(gridPos) != Solver::Knowledge::Unknown)
+		{
+			candidates[slot] = candidates.back();
+			candidates.pop_back();
+			continue;
+		}
+
+		return { Click::Type::Reveal, gridPos };
+	}
+
+	// A running game always has an unknown tile, a safe tile or an unflagged mine left
+	assert(false);
+	return { Click::Type::Reveal, { 0,0 } };
+}
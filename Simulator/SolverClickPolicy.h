@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ClickPolicy.h"
+#include "ProbabilityEngine.h"
+#include "Solver.h"
+#include "Xoshiro256.h"
+#include <vector>
+#include <stddef.h>
+
+// Plays every move the Solver can prove: reveals safe tiles, flags mines,
+// and only guesses when nothing is certain. Guesses are random unknown tiles,
+// or the tile least likely to be a mine when useProbabilities is set
+class SolverClickPolicy : public ClickPolicy
+{
+public:
+	SolverClickPolicy(uint64_t seed, bool useProbabilities = false);
+	void OnNewGame(const MineField& field) override;
+	Click NextClick(const MineField& field) override;
+
+private:
+	uint64_t seed;
+	bool useProbabilities;
+	Xoshiro256 rng;
+	Solver solver;
+	ProbabilityEngine probabilities;
+	// Positions in the solver's safe and mine lists up to which tiles have been played
+	size_t nSafePlayed = 0;
+	size_t nMinesFlagged = 0;
+	// Tiles that may still be unknown. Dropped lazily when picked
+	std::vector<int> candidates;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checking for the test programs run by CTest: a failed check prints where it
+// failed, and the program fails if any check did
+namespace Check
+{
+	static int nFailures = 0;
+
+	inline void Report(bool passed, const char* condition, const char* file, int line)
+	{
+		if (!passed)
+		{
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+			nFailures++;
+		}
+	}
+
+	inline int Result()
+	{
+		return nFailures == 0 ? 0 : 1;
+	}
+}
+
+#define CHECK(condition) Check::Report((condition), #condition, __FILE__, __LINE__)
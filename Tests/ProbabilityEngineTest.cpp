@@ -0,0 +1,128 @@
+// ProbabilityEngine against brute force: on small boards every mine layout that agrees
+// with the revealed numbers and the mine count is enumerated, and each hidden tile's
+// share of them must match the engine's probability
+#include "Check.h"
+#include "ProbabilityEngine.h"
+#include "Xoshiro256.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	class BruteForce
+	{
+	public:
+		BruteForce(const MineField& field)
+			:field(field),
+			width(field.GetWidth()),
+			height(field.GetHeight()),
+			isMine(width * height, false),
+			mineCounts(width * height, 0.0)
+		{
+			Place(0, 0);
+		}
+		double GetProbability(int t) const
+		{
+			return mineCounts[t] / nLayouts;
+		}
+	private:
+		void Place(int t, int nPlaced)
+		{
+			if (nPlaced == field.GetMineCount())
+			{
+				if (IsConsistent())
+				{
+					nLayouts++;
+					for (int i = 0; i < width * height; i++)
+					{
+						mineCounts[i] += isMine[i] ? 1.0 : 0.0;
+					}
+				}
+				return;
+			}
+			if (t == width * height)
+			{
+				return;
+			}
+			if (!field.IsRevealed({ t % width, t / width }))
+			{
+				isMine[t] = true;
+				Place(t + 1, nPlaced + 1);
+				isMine[t] = false;
+			}
+			Place(t + 1, nPlaced);
+		}
+		bool IsConsistent() const
+		{
+			for (int t = 0; t < width * height; t++)
+			{
+				const Vei2 pos = { t % width, t / width };
+				if (!field.IsRevealed(pos))
+				{
+					continue;
+				}
+				int n = 0;
+				for (int y = pos.y - 1; y <= pos.y + 1; y++)
+				{
+					for (int x = pos.x - 1; x <= pos.x + 1; x++)
+					{
+						n += field.IsInside({ x,y }) && isMine[y * width + x] ? 1 : 0;
+					}
+				}
+				if (n != field.GetNeighborBombCount(pos))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	private:
+		const MineField& field;
+		int width;
+		int height;
+		std::vector<bool> isMine;
+		std::vector<double> mineCounts;
+		double nLayouts = 0.0;
+	};
+}
+
+int main()
+{
+	ProbabilityEngine engine;
+	int nCompared = 0;
+	for (uint64_t seed = 1; seed <= 400; seed++)
+	{
+		Xoshiro256 rng(seed);
+		const int width = 4 + int(rng.Bounded(3u));
+		const int height = 4;
+		const int nMines = 3 + int(rng.Bounded(3u));
+		MineField field(width, height, nMines, seed);
+
+		// A few safe reveals, so both frontier and interior tiles are left
+		const int nClicks = 1 + int(rng.Bounded(3u));
+		for (int c = 0; c < nClicks; c++)
+		{
+			const Vei2 pos = { int(rng.Bounded(uint32_t(width))), int(rng.Bounded(uint32_t(height))) };
+			if (!field.HasBomb(pos))
+			{
+				field.OnRevealClick(pos);
+			}
+		}
+		if (field.GetState() != MineField::State::Mineming)
+		{
+			continue;
+		}
+
+		CHECK(engine.Compute(field));
+		const BruteForce reference(field);
+		for (int t = 0; t < width * height; t++)
+		{
+			const Vei2 pos = { t % width, t / width };
+			const double expected = field.IsRevealed(pos) ? 0.0 : reference.GetProbability(t);
+			CHECK(std::fabs(engine.GetMineProbability(pos) - expected) < 1e-5);
+		}
+		nCompared++;
+	}
+	CHECK(nCompared > 300);
+	return Check::Result();
+}
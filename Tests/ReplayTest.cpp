@@ -0,0 +1,113 @@
+// Replays: a recorded winning game verifies, with the time of its last click, any
+// tampering with the stream is refused, and the field it names can be checked
+#include "Check.h"
+#include "MineField.h"
+#include "Replay.h"
+#include "Xoshiro256.h"
+#include <vector>
+
+namespace
+{
+	// Wins by revealing every safe tile and flagging every mine, in a random order
+	Replay RecordWin(int width, int height, int nMines, uint64_t seed)
+	{
+		MineField field(width, height, nMines, seed);
+		Replay replay(width, height, nMines, seed);
+		Xoshiro256 rng(seed);
+
+		std::vector<int> order(width * height);
+		for (int t = 0; t < width * height; t++)
+		{
+			order[t] = t;
+		}
+		for (int t = width * height - 1; t > 0; t--)
+		{
+			std::swap(order[t], order[rng.Bounded(uint32_t(t) + 1u)]);
+		}
+
+		uint32_t timeMs = 0u;
+		for (int t : order)
+		{
+			const Vei2 pos = { t % width, t / width };
+			if (field.IsRevealed(pos))
+			{
+				continue;
+			}
+			timeMs += rng.Bounded(2000u);
+			const Replay::Action action = field.HasBomb(pos) ? Replay::Action::Flag : Replay::Action::Reveal;
+			replay.AddClick(pos, action, timeMs);
+			if (action == Replay::Action::Flag)
+			{
+				field.OnFlagClick(pos);
+			}
+			else
+			{
+				field.OnRevealClick(pos);
+			}
+		}
+		CHECK(field.GetState() == MineField::State::Winrar);
+		return replay;
+	}
+
+	bool Verifies(const std::vector<unsigned char>& bytes)
+	{
+		uint32_t winTimeMs;
+		return Replay(bytes).Verify(winTimeMs);
+	}
+}
+
+int main()
+{
+	for (uint64_t seed = 1; seed <= 100; seed++)
+	{
+		const Replay replay = RecordWin(16, 16, 40, seed);
+		const std::vector<unsigned char>& good = replay.GetBytes();
+
+		uint32_t winTimeMs = 0u;
+		CHECK(Replay(good).Verify(winTimeMs));
+		CHECK(winTimeMs > 0u);
+
+		// Another seed is another field, the same clicks hit mines or miss the win. The seed
+		// is the one byte varint after the magic, version, width, height and mine count
+		std::vector<unsigned char> bad = good;
+		bad[8] ^= 0x40u;
+		CHECK(!Verifies(bad));
+
+		// The last click moved to the tile left of it no longer wins
+		bad = good;
+		bad.back() = (unsigned char)(bad.back() - 4u);
+		CHECK(!Verifies(bad));
+
+		// Dropping the last click leaves the game unfinished
+		bad.assign(good.begin(), good.end() - 2);
+		CHECK(!Verifies(bad));
+
+		// Nothing may follow the winning click
+		bad = good;
+		bad.push_back(0u);
+		bad.push_back(0u);
+		CHECK(!Verifies(bad));
+
+		bad = good;
+		bad[0] = 'X';
+		CHECK(!Verifies(bad));
+
+		bad = good;
+		bad[4]++;
+		CHECK(!Verifies(bad));
+	}
+
+	// The header names the field, and a tiny forged game only passes when no field is asked for
+	const Replay expert = RecordWin(30, 16, 99, 7);
+	Replay::Field field;
+	CHECK(expert.ReadField(field));
+	CHECK(field.width == 30 && field.height == 16 && field.nMines == 99 && field.seed == 7u && !field.hasSafeStart);
+	uint32_t winTimeMs = 0u;
+	CHECK(expert.Verify(30, 16, 99, winTimeMs));
+
+	const Replay forged = RecordWin(2, 1, 1, 7);
+	CHECK(forged.Verify(winTimeMs));
+	CHECK(!forged.Verify(30, 16, 99, winTimeMs));
+	CHECK(!Replay(std::vector<unsigned char>(3, 0u)).ReadField(field));
+	return Check::Result();
+}
@@ -0,0 +1,364 @@
+// Reveals: clicks, chords, flags and undo must uncover exactly the tiles a plain flood
+// fill from the clicked tile does, on fields small enough to flood fill and on fields big
+// enough to sweep precomputed openings
+#include "Check.h"
+#include "MineField.h"
+#include "Xoshiro256.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	// The rules played on plain arrays, one byte per tile
+	class Reference
+	{
+	public:
+		Reference(const MineField& field)
+			:width(field.GetWidth()),
+			height(field.GetHeight()),
+			mines(width * height),
+			counts(width * height),
+			revealed(width * height, 0u),
+			flagged(width * height, 0u)
+		{
+			for (int i = 0; i < width * height; i++)
+			{
+				mines[i] = field.HasBomb({ i % width, i / width }) ? 1u : 0u;
+				counts[i] = (unsigned char)field.GetNeighborBombCount({ i % width, i / width });
+			}
+		}
+		void Reveal(const Vei2& pos)
+		{
+			const int i = pos.y * width + pos.x;
+			if (isRunning && !revealed[i] && !flagged[i])
+			{
+				RevealFrom(i);
+			}
+		}
+		void Flag(const Vei2& pos)
+		{
+			const int i = pos.y * width + pos.x;
+			if (isRunning && !revealed[i])
+			{
+				flagged[i] ^= 1u;
+			}
+		}
+		void Chord(const Vei2& pos)
+		{
+			const int i = pos.y * width + pos.x;
+			if (!isRunning || !revealed[i] || counts[i] == 0u)
+			{
+				return;
+			}
+			int nFlags = 0;
+			ForNeighbors(i, [&](int n) { nFlags += flagged[n]; });
+			if (nFlags == counts[i])
+			{
+				ForNeighbors(i, [&](int n)
+				{
+					if (!revealed[n] && !flagged[n])
+					{
+						RevealFrom(n);
+					}
+				});
+			}
+		}
+		bool Matches(const MineField& field) const
+		{
+			bool isWon = true;
+			for (int i = 0; i < width * height; i++)
+			{
+				const Vei2 pos = { i % width, i / width };
+				if (field.IsRevealed(pos) != (revealed[i] != 0u) || field.IsFlagged(pos) != (flagged[i] != 0u))
+				{
+					return false;
+				}
+				isWon = isWon && (mines[i] ? flagged[i] != 0u : revealed[i] != 0u);
+			}
+			const MineField::State state = !isRunning ? MineField::State::Fucked :
+				isWon ? MineField::State::Winrar : MineField::State::Mineming;
+			return field.GetState() == state;
+		}
+		bool IsRunning() const
+		{
+			return isRunning && !Won();
+		}
+		// Safe tiles revealed here but not in before, in index order
+		std::vector<int> RevealedSince(const Reference& before) const
+		{
+			std::vector<int> tiles;
+			for (int i = 0; i < width * height; i++)
+			{
+				if (revealed[i] && !before.revealed[i] && !mines[i])
+				{
+					tiles.push_back(i);
+				}
+			}
+			return tiles;
+		}
+		bool operator!=(const Reference& rhs) const
+		{
+			return revealed != rhs.revealed || flagged != rhs.flagged;
+		}
+	private:
+		template<typename F>
+		void ForNeighbors(int i, F f) const
+		{
+			const int x = i % width;
+			const int y = i / width;
+			for (int ny = y - 1; ny <= y + 1; ny++)
+			{
+				for (int nx = x - 1; nx <= x + 1; nx++)
+				{
+					if (nx >= 0 && nx < width && ny >= 0 && ny < height && (nx != x || ny != y))
+					{
+						f(ny * width + nx);
+					}
+				}
+			}
+		}
+		void RevealFrom(int i)
+		{
+			revealed[i] = 1u;
+			if (mines[i])
+			{
+				isRunning = false;
+				return;
+			}
+			std::vector<int> queue;
+			if (counts[i] == 0u)
+			{
+				queue.push_back(i);
+			}
+			while (!queue.empty())
+			{
+				const int t = queue.back();
+				queue.pop_back();
+				ForNeighbors(t, [&](int n)
+				{
+					if (!revealed[n] && !flagged[n])
+					{
+						revealed[n] = 1u;
+						if (counts[n] == 0u)
+						{
+							queue.push_back(n);
+						}
+					}
+				});
+			}
+		}
+		bool Won() const
+		{
+			for (int i = 0; i < width * height; i++)
+			{
+				if (mines[i] ? !flagged[i] : !revealed[i])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	private:
+		int width;
+		int height;
+		std::vector<unsigned char> mines;
+		std::vector<unsigned char> counts;
+		std::vector<unsigned char> revealed;
+		std::vector<unsigned char> flagged;
+		bool isRunning = true;
+	};
+
+	// Collects the tiles of Reveal events
+	class RevealLog : public MineField::Observer
+	{
+	public:
+		RevealLog(int width)
+			:width(width)
+		{
+		}
+		void OnEvent(const MineField::Event& e) override
+		{
+			if (e.GetType() == MineField::Event::Type::Reveal)
+			{
+				tiles.push_back(e.GetPos().y * width + e.GetPos().x);
+			}
+		}
+		// Sorted tiles since the last call
+		std::vector<int> Take()
+		{
+			std::vector<int> taken;
+			taken.swap(tiles);
+			std::sort(taken.begin(), taken.end());
+			return taken;
+		}
+	private:
+		int width;
+		std::vector<int> tiles;
+	};
+
+	// Random clicks with flags, unflags and undos, checked against the reference after each.
+	// history holds the reference after every move in the field's undo journal. Every
+	// newly revealed safe tile must be reported with exactly one Reveal event
+	void PlayRandom(int width, int height, int nMines, uint64_t seed, int nMoves)
+	{
+		MineField field(width, height, nMines, seed);
+		field.EnableUndo();
+		RevealLog log(width);
+		field.SetObserver(&log);
+		std::vector<Reference> history(1, Reference(field));
+		Xoshiro256 rng(seed);
+
+		for (int m = 0; m < nMoves; m++)
+		{
+			const uint32_t kind = rng.Bounded(10u);
+			if (history.size() > 1 && (kind == 0u || !history.back().IsRunning()))
+			{
+				field.Undo();
+				history.pop_back();
+				CHECK(history.back().Matches(field));
+				continue;
+			}
+
+			Reference ref = history.back();
+			const Vei2 pos = { int(rng.Bounded(uint32_t(width))), int(rng.Bounded(uint32_t(height))) };
+			if (kind < 5u)
+			{
+				field.OnFlagClick(pos);
+				ref.Flag(pos);
+			}
+			else if (kind < 7u)
+			{
+				field.OnChordClick(pos);
+				ref.Chord(pos);
+			}
+			else if (!field.HasBomb(pos) || rng.Bounded(20u) == 0u)
+			{
+				field.OnRevealClick(pos);
+				ref.Reveal(pos);
+			}
+
+			const bool matches = ref.Matches(field);
+			CHECK(matches);
+			CHECK(log.Take() == ref.RevealedSince(history.back()));
+			if (!matches)
+			{
+				return;
+			}
+			if (ref != history.back())
+			{
+				history.push_back(ref);
+			}
+		}
+	}
+
+	// The opening count must match the zero areas a flood fill finds, labeled or not
+	void CountOpenings(int width, int height, int nMines, uint64_t seed)
+	{
+		const MineField field(width, height, nMines, seed);
+		const unsigned char* const counts = field.GetNeighborCounts();
+		std::vector<unsigned char> seen(width * height, 0u);
+		std::vector<int> stack;
+		int nOpenings = 0;
+		for (int first = 0; first < width * height; first++)
+		{
+			if (counts[first] != 0u || seen[first] != 0u)
+			{
+				continue;
+			}
+			nOpenings++;
+			seen[first] = 1u;
+			stack.assign(1, first);
+			while (!stack.empty())
+			{
+				const int x = stack.back() % width;
+				const int y = stack.back() / width;
+				stack.pop_back();
+				for (int ny = std::max(0, y - 1); ny <= std::min(height - 1, y + 1); ny++)
+				{
+					for (int nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); nx++)
+					{
+						const int n = ny * width + nx;
+						if (counts[n] == 0u && seen[n] == 0u)
+						{
+							seen[n] = 1u;
+							stack.push_back(n);
+						}
+					}
+				}
+			}
+		}
+		CHECK(field.GetOpeningCount() == nOpenings);
+	}
+
+	// A tile cut off from the clicked tile by ground revealed earlier must stay hidden.
+	// Flags wall off one side of the single mine and the border tile next to it while the
+	// mine side is revealed, then the other side is revealed with no flags left. The
+	// border tile only touches zero tiles of the first reveal, so it stays hidden
+	void CutOffTile(int width, int height, uint64_t seed)
+	{
+		MineField field(width, height, 1, seed);
+		Reference ref(field);
+		int mine = 0;
+		while (!field.HasBomb({ mine % width, mine / width }))
+		{
+			mine++;
+		}
+		const Vei2 minePos = { mine % width, mine / width };
+
+		const bool isMineRight = minePos.x >= width / 2;
+		const int wallX = isMineRight ? 1 : width - 2;
+		// The mine's neighbor on the side away from the wall, unless the mine is at the edge
+		const int awayX = isMineRight ? minePos.x + 1 : minePos.x - 1;
+		const Vei2 border = { awayX >= 0 && awayX < width ? awayX : 2 * minePos.x - awayX, minePos.y };
+		const Vei2 wallSide = { isMineRight ? 0 : width - 1, 0 };
+		// Any zero tile between the wall and the mine
+		Vei2 mineSide = { wallX,0 };
+		while (mineSide.x == wallX || field.GetNeighborBombCount(mineSide) != 0)
+		{
+			mineSide.x = isMineRight ? mineSide.x + 1 : mineSide.x - 1;
+		}
+
+		auto toggleFlags = [&]()
+		{
+			for (int y = 0; y < height; y++)
+			{
+				field.OnFlagClick({ wallX,y });
+				ref.Flag({ wallX,y });
+			}
+			field.OnFlagClick(border);
+			ref.Flag(border);
+		};
+		toggleFlags();
+		field.OnRevealClick(mineSide);
+		ref.Reveal(mineSide);
+		toggleFlags();
+		field.OnRevealClick(wallSide);
+		ref.Reveal(wallSide);
+
+		CHECK(!field.IsRevealed(border));
+		CHECK(ref.Matches(field));
+	}
+}
+
+int main()
+{
+	CutOffTile(7, 3, 1);
+	CutOffTile(400, 200, 2);
+	CutOffTile(300, 300, 3);
+	for (uint64_t seed = 1; seed <= 200; seed++)
+	{
+		PlayRandom(9, 9, 10, seed, 300);
+		PlayRandom(30, 16, 40, seed, 300);
+	}
+	for (uint64_t seed = 1; seed <= 8; seed++)
+	{
+		PlayRandom(300, 220, int(seed) * 400, seed, 300);
+	}
+	for (uint64_t seed = 1; seed <= 20; seed++)
+	{
+		CountOpenings(9, 9, 10, seed);
+		CountOpenings(30, 16, 30 + int(seed) * 3, seed);
+		CountOpenings(300, 220, int(seed) * 400, seed);
+	}
+	return Check::Result();
+}
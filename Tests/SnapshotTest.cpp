@@ -0,0 +1,183 @@
+// Snapshots: a loaded field must match the saved one tile for tile and play on the same
+// way, and damaged or foreign files must be refused
+#include "Check.h"
+#include "MineField.h"
+#include "Xoshiro256.h"
+#include <cstdio>
+#include <utility>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const char* const snapshotPath = "SnapshotTest.mfs";
+
+	bool SameField(const MineField& a, const MineField& b)
+	{
+		if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() ||
+			a.GetMineCount() != b.GetMineCount() || a.GetSeed() != b.GetSeed() ||
+			a.GetState() != b.GetState() || a.GetUnrevealedCount() != b.GetUnrevealedCount())
+		{
+			return false;
+		}
+		for (Vei2 pos = { 0,0 }; pos.y < a.GetHeight(); pos.y++)
+		{
+			for (pos.x = 0; pos.x < a.GetWidth(); pos.x++)
+			{
+				if (a.HasBomb(pos) != b.HasBomb(pos) || a.IsRevealed(pos) != b.IsRevealed(pos) ||
+					a.IsFlagged(pos) != b.IsFlagged(pos) ||
+					a.GetNeighborBombCount(pos) != b.GetNeighborBombCount(pos))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void Click(MineField& field, Xoshiro256& rng)
+	{
+		const Vei2 pos = { int(rng.Bounded(uint32_t(field.GetWidth()))), int(rng.Bounded(uint32_t(field.GetHeight()))) };
+		if (rng.Bounded(3u) == 0u)
+		{
+			field.OnFlagClick(pos);
+		}
+		else if (!field.HasBomb(pos))
+		{
+			field.OnRevealClick(pos);
+		}
+	}
+
+	void RoundTrip(int width, int height, int nMines, uint64_t seed)
+	{
+		MineField field(width, height, nMines, seed);
+		Xoshiro256 rng(seed);
+		for (int c = 0; c < 20; c++)
+		{
+			Click(field, rng);
+		}
+
+		CHECK(field.Save(snapshotPath));
+		const std::unique_ptr<MineField> pLoaded = MineField::Load(snapshotPath);
+		CHECK(pLoaded != nullptr);
+		if (pLoaded == nullptr)
+		{
+			return;
+		}
+		CHECK(SameField(field, *pLoaded));
+
+		// Both play on identically, the loaded one on its mapped planes
+		Xoshiro256 rngLoaded = rng;
+		for (int c = 0; c < 40; c++)
+		{
+			Click(field, rng);
+			Click(*pLoaded, rngLoaded);
+		}
+		CHECK(SameField(field, *pLoaded));
+	}
+
+	std::vector<unsigned char> ReadFile(const char* path)
+	{
+		std::vector<unsigned char> bytes;
+		FILE* const pFile = std::fopen(path, "rb");
+		for (int c; pFile != nullptr && (c = std::fgetc(pFile)) != EOF; )
+		{
+			bytes.push_back((unsigned char)c);
+		}
+		if (pFile != nullptr)
+		{
+			std::fclose(pFile);
+		}
+		return bytes;
+	}
+
+	bool LoadsAfterWriting(const std::vector<unsigned char>& bytes)
+	{
+		FILE* const pFile = std::fopen(snapshotPath, "wb");
+		std::fwrite(bytes.data(), 1, bytes.size(), pFile);
+		std::fclose(pFile);
+		return MineField::Load(snapshotPath) != nullptr;
+	}
+
+	void RejectsDamage()
+	{
+		MineField field(30, 16, 99, 7);
+		CHECK(field.Save(snapshotPath));
+		const std::vector<unsigned char> good = ReadFile(snapshotPath);
+		CHECK(LoadsAfterWriting(good));
+
+		std::vector<unsigned char> bad = good;
+		bad[0] ^= 1u;
+		CHECK(!LoadsAfterWriting(bad));
+
+		bad = good;
+		bad[4] ^= 1u;
+		CHECK(!LoadsAfterWriting(bad));
+
+		// Neighbor counts that do not match the mines
+		bad = good;
+		bad.back() ^= 1u;
+		CHECK(!LoadsAfterWriting(bad));
+
+		bad = good;
+		bad[bad.size() - 100] = 10u;
+		CHECK(!LoadsAfterWriting(bad));
+
+		// Counts that add up right but sit on the wrong tiles
+		const size_t countsStart = good.size() - size_t(field.GetWidth() * field.GetHeight());
+		size_t other = countsStart + 1;
+		while (good[other] == good[countsStart])
+		{
+			other++;
+		}
+		bad = good;
+		std::swap(bad[countsStart], bad[other]);
+		CHECK(!LoadsAfterWriting(bad));
+
+		// Planes start after the 32-byte header, 8 words each on this field
+		const size_t planeSize = 8 * 8;
+		const size_t minesStart = 32;
+		const size_t revealedStart = minesStart + planeSize;
+		const size_t flaggedStart = revealedStart + planeSize;
+		int mine = 0;
+		while (!field.HasBomb({ mine % field.GetWidth(),mine / field.GetWidth() }))
+		{
+			mine++;
+		}
+
+		// A revealed tile that is also flagged
+		bad = good;
+		bad[revealedStart] |= 1u;
+		bad[flaggedStart] |= 1u;
+		CHECK(!LoadsAfterWriting(bad));
+
+		// A revealed mine in a running game
+		bad = good;
+		bad[revealedStart + size_t(mine / 8)] |= (unsigned char)(1u << (mine % 8));
+		CHECK(!LoadsAfterWriting(bad));
+
+		bad = good;
+		bad.pop_back();
+		CHECK(!LoadsAfterWriting(bad));
+
+		bad = good;
+		bad.push_back(0u);
+		CHECK(!LoadsAfterWriting(bad));
+
+		CHECK(!LoadsAfterWriting(std::vector<unsigned char>(good.begin(), good.begin() + 16)));
+		CHECK(MineField::Load("SnapshotTest.missing") == nullptr);
+	}
+}
+
+int main()
+{
+	for (uint64_t seed = 1; seed <= 50; seed++)
+	{
+		RoundTrip(9, 9, 10, seed);
+		RoundTrip(30, 16, 99, seed);
+		RoundTrip(100, 70, 900, seed);
+	}
+	RejectsDamage();
+	std::remove(snapshotPath);
+	return Check::Result();
+}
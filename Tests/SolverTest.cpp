@@ -0,0 +1,62 @@
+// The Solver must never mark a tile wrongly: every tile it proves safe is free of mines
+// and every tile it proves to be a mine holds one. Games are played to the end on
+// random boards, revealing a random safe tile whenever the solver is stuck
+#include "Check.h"
+#include "Solver.h"
+#include "Xoshiro256.h"
+
+namespace
+{
+	void PlayGame(int width, int height, int nMines, uint64_t seed)
+	{
+		const Vei2 firstClick = { width / 2, height / 2 };
+		MineField field(width, height, nMines, seed, firstClick);
+		field.OnRevealClick(firstClick);
+
+		Solver solver;
+		Xoshiro256 rng(seed);
+		while (field.GetState() == MineField::State::Mineming && field.GetUnrevealedCount() > nMines)
+		{
+			solver.Update(field);
+			for (int t : solver.GetMineTiles())
+			{
+				CHECK(field.HasBomb({ t % width, t / width }));
+			}
+
+			bool progressed = false;
+			for (int t : solver.GetSafeTiles())
+			{
+				const Vei2 pos = { t % width, t / width };
+				CHECK(!field.HasBomb(pos));
+				if (!field.IsRevealed(pos) && !field.HasBomb(pos))
+				{
+					field.OnRevealClick(pos);
+					progressed = true;
+				}
+			}
+
+			// Stuck: take a safe tile the solver could not prove, like a lucky guess
+			while (!progressed)
+			{
+				const Vei2 pos = { int(rng.Bounded(uint32_t(width))), int(rng.Bounded(uint32_t(height))) };
+				if (!field.IsRevealed(pos) && !field.HasBomb(pos))
+				{
+					field.OnRevealClick(pos);
+					progressed = true;
+				}
+			}
+		}
+		CHECK(field.GetState() == MineField::State::Mineming);
+	}
+}
+
+int main()
+{
+	for (uint64_t seed = 1; seed <= 300; seed++)
+	{
+		PlayGame(9, 9, 10, seed);
+		PlayGame(16, 16, 40, seed);
+		PlayGame(30, 16, 99, seed);
+	}
+	return Check::Result();
+}
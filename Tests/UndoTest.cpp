@@ -0,0 +1,108 @@
+// Undo journal: undoing every move must step back through the exact states the game
+// went through, down to the fresh field, and redoing them all must end where it began
+#include "Check.h"
+#include "MineField.h"
+#include "Xoshiro256.h"
+#include <vector>
+
+namespace
+{
+	// Everything the player can see, plus the win-check counter
+	struct View
+	{
+		std::vector<uint64_t> revealed;
+		std::vector<bool> flagged;
+		MineField::State state;
+		int nUnrevealed;
+
+		View(const MineField& field)
+			:revealed(field.GetRevealedPlane().GetWords(),
+				field.GetRevealedPlane().GetWords() + field.GetRevealedPlane().GetWordCount()),
+			state(field.GetState()),
+			nUnrevealed(field.GetUnrevealedCount())
+		{
+			for (int t = 0; t < field.GetWidth() * field.GetHeight(); t++)
+			{
+				flagged.push_back(field.IsFlagged({ t % field.GetWidth(), t / field.GetWidth() }));
+			}
+		}
+		bool operator==(const View& rhs) const
+		{
+			return revealed == rhs.revealed && flagged == rhs.flagged &&
+				state == rhs.state && nUnrevealed == rhs.nUnrevealed;
+		}
+	};
+
+	void PlayAndRewind(int width, int height, int nMines, uint64_t seed)
+	{
+		MineField field(width, height, nMines, seed);
+		field.EnableUndo();
+		Xoshiro256 rng(seed);
+
+		// Views before the first move and after every move that changed the field
+		std::vector<View> history = { View(field) };
+		while (field.GetState() == MineField::State::Mineming && history.size() < 200)
+		{
+			const Vei2 pos = { int(rng.Bounded(uint32_t(width))), int(rng.Bounded(uint32_t(height))) };
+			switch (rng.Bounded(4u))
+			{
+			case 0:
+				field.OnFlagClick(pos);
+				break;
+			case 1:
+				field.OnChordClick(pos);
+				break;
+			default:
+				// Mostly safe reveals, so games get far before they end
+				if (!field.HasBomb(pos) || rng.Bounded(8u) == 0u)
+				{
+					field.OnRevealClick(pos);
+				}
+				break;
+			}
+			if (!(View(field) == history.back()))
+			{
+				history.push_back(View(field));
+			}
+		}
+
+		for (size_t m = history.size() - 1; m > 0; m--)
+		{
+			CHECK(field.CanUndo());
+			field.Undo();
+			CHECK(View(field) == history[m - 1]);
+		}
+		CHECK(!field.CanUndo());
+
+		for (size_t m = 1; m < history.size(); m++)
+		{
+			CHECK(field.CanRedo());
+			field.Redo();
+			CHECK(View(field) == history[m]);
+		}
+		CHECK(!field.CanRedo());
+	}
+
+	// Undo is opt-in, a field that never enabled it keeps no journal
+	void PlayWithoutUndo(uint64_t seed)
+	{
+		MineField field(9, 9, 10, seed);
+		field.OnFlagClick({ 0,0 });
+		field.OnRevealClick({ 4,4 });
+		CHECK(!field.CanUndo());
+		const View played(field);
+		field.Undo();
+		CHECK(View(field) == played);
+	}
+}
+
+int main()
+{
+	for (uint64_t seed = 1; seed <= 300; seed++)
+	{
+		PlayAndRewind(9, 9, 10, seed);
+		PlayAndRewind(30, 16, 60, seed);
+	}
+	PlayWithoutUndo(1);
+	return Check::Result();
+}
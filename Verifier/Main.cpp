@@ -0,0 +1,135 @@
+// Checks recorded games, e.g. leaderboard submissions. Every replay is played back
+// headless on the field it names, at full speed. Prints one line per file with the
+// field (width x height / mines, seed) and the time of the winning click, or why the
+// replay was refused.
+//
+// Usage: Verifier [--width W --height H --mines M] replay [replay ...]
+//
+// The field comes from the replay itself, so a leaderboard passes the board it ranks:
+// with --width, --height and --mines, replays of any other field are refused.
+// Exits with 0 when every replay is a won game, 1 otherwise
+#include "Replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	struct Options
+	{
+		// Expected field, 0 when any field is accepted
+		int width = 0;
+		int height = 0;
+		int nMines = 0;
+		int firstReplay = 1;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		int i = 1;
+		for (; i < argc && std::strncmp(argv[i], "--", 2) == 0; i++)
+		{
+			const char* arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "Missing value for %s\n", arg);
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (std::strcmp(arg, "--width") == 0)
+			{
+				options.width = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--height") == 0)
+			{
+				options.height = std::atoi(value);
+			}
+			else if (std::strcmp(arg, "--mines") == 0)
+			{
+				options.nMines = std::atoi(value);
+			}
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", arg);
+				return false;
+			}
+		}
+		options.firstReplay = i;
+
+		const bool anyField = options.width != 0 || options.height != 0 || options.nMines != 0;
+		if (anyField && (options.width <= 0 || options.height <= 0 || options.nMines <= 0))
+		{
+			std::fprintf(stderr, "--width, --height and --mines go together\n");
+			return false;
+		}
+		if (options.firstReplay >= argc)
+		{
+			std::fprintf(stderr, "Usage: Verifier [--width W --height H --mines M] replay [replay ...]\n");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+	const bool checkField = options.width != 0;
+	const int nReplays = argc - options.firstReplay;
+
+	int nValid = 0;
+	std::chrono::steady_clock::duration verifyTime(0);
+	for (int i = options.firstReplay; i < argc; i++)
+	{
+		const std::unique_ptr<Replay> pReplay = Replay::Load(argv[i]);
+		if (pReplay == nullptr)
+		{
+			std::printf("%s unreadable\n", argv[i]);
+			continue;
+		}
+
+		Replay::Field field;
+		if (!pReplay->ReadField(field))
+		{
+			std::printf("%s invalid header\n", argv[i]);
+			continue;
+		}
+		char fieldName[96];
+		std::snprintf(fieldName, sizeof(fieldName), "%dx%d/%d seed %llu", field.width, field.height,
+			field.nMines, (unsigned long long)field.seed);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		uint32_t winTimeMs;
+		const bool valid = checkField ?
+			pReplay->Verify(options.width, options.height, options.nMines, winTimeMs) :
+			pReplay->Verify(winTimeMs);
+		verifyTime += std::chrono::steady_clock::now() - start;
+
+		if (valid)
+		{
+			std::printf("%s won %u ms on %s\n", argv[i], (unsigned)winTimeMs, fieldName);
+			nValid++;
+		}
+		else if (checkField && (field.width != options.width || field.height != options.height ||
+			field.nMines != options.nMines))
+		{
+			std::printf("%s wrong field %s\n", argv[i], fieldName);
+		}
+		else
+		{
+			std::printf("%s invalid on %s\n", argv[i], fieldName);
+		}
+	}
+
+	std::fprintf(stderr, "Replays:      %d valid of %d\n", nValid, nReplays);
+	std::fprintf(stderr, "Verify time:  %.1f us per replay\n",
+		std::chrono::duration<double, std::micro>(verifyTime).count() / double(nReplays));
+
+	return nValid == nReplays ? 0 : 1;
+}